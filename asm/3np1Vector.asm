@@ -0,0 +1,128 @@
+global p3np1Avx2
+global p3np1Avx512
+section .text
+
+; Batched 3n+1: exact step counts to reach 1 (n even: n/2, n odd: 3n+1; 0 and 1 take no steps).
+; rdi = starting values, rsi = step counts out, rdx = count, a multiple of the group size.
+; Each group of two vectors runs until all of its lanes reach 1; lanes that are done are held
+; by a per-lane mask and stop counting. Values wrap modulo 2^64 like p3np1E.
+
+; One step of one AVX2 vector: %1 values, %2 finished-step counters, %3-%6 scratch.
+; ymm13 = all ones, ymm14 = 1.
+%macro STEP_AVX2 6
+        vpsrlq %3, %1, 1                ; n / 2
+        vpxor %4, %4, %4
+        vpcmpeqq %4, %3, %4             ; n <= 1: this lane is done
+        vpaddq %5, %1, %1
+        vpaddq %5, %5, %1
+        vpaddq %5, %5, ymm14            ; 3n + 1
+        vpsllq %6, %1, 63               ; odd lanes in the sign bit, which vblendvpd reads
+        vblendvpd %5, %3, %5, %6
+        vblendvpd %1, %5, %1, %4        ; done lanes keep their value
+        vpsubq %2, %2, %4               ; and count this step as not taken
+%endmacro
+
+p3np1Avx2:
+        push rbp
+        mov rbp, rsp
+
+        vpcmpeqq ymm13, ymm13, ymm13
+        vpsrlq ymm14, ymm13, 63
+
+.group:
+        test rdx, rdx
+        jz .done
+
+        vmovdqu ymm0, [rdi]
+        vmovdqu ymm1, [rdi+32]
+        vpxor ymm2, ymm2, ymm2
+        vpxor ymm3, ymm3, ymm3
+        xor rax, rax                    ; Steps the group has run
+
+.loop:
+        STEP_AVX2 ymm0, ymm2, ymm4, ymm5, ymm6, ymm7
+        STEP_AVX2 ymm1, ymm3, ymm8, ymm9, ymm10, ymm11
+        STEP_AVX2 ymm0, ymm2, ymm4, ymm5, ymm6, ymm7
+        STEP_AVX2 ymm1, ymm3, ymm8, ymm9, ymm10, ymm11
+        STEP_AVX2 ymm0, ymm2, ymm4, ymm5, ymm6, ymm7
+        STEP_AVX2 ymm1, ymm3, ymm8, ymm9, ymm10, ymm11
+        STEP_AVX2 ymm0, ymm2, ymm4, ymm5, ymm6, ymm7
+        STEP_AVX2 ymm1, ymm3, ymm8, ymm9, ymm10, ymm11
+        add rax, 4
+
+        vpand ymm12, ymm5, ymm9         ; Done masks of the last step
+        vptest ymm12, ymm13             ; CF: every lane of both vectors is done
+        jnc .loop
+
+        vmovq xmm12, rax
+        vpbroadcastq ymm12, xmm12
+        vpsubq ymm2, ymm12, ymm2
+        vpsubq ymm3, ymm12, ymm3
+        vmovdqu [rsi], ymm2
+        vmovdqu [rsi+32], ymm3
+
+        add rdi, 64
+        add rsi, 64
+        sub rdx, 8
+        jmp .group
+
+.done:
+        vzeroupper
+        pop rbp
+        ret
+
+; One step of one AVX-512 vector: %1 values, %2 step counters, %3-%4 scratch, %5-%6 masks.
+; zmm15 = 1.
+%macro STEP_AVX512 6
+        vpsrlq %3, %1, 1                ; n / 2
+        vptestmq %5, %3, %3             ; n > 1: this lane is still running
+        vptestmq %6{%5}, %1, zmm15      ; running and odd
+        vpaddq %4, %1, %1
+        vpaddq %4, %4, %1
+        vpaddq %4, %4, zmm15            ; 3n + 1
+        vmovdqa64 %1{%5}, %3
+        vmovdqa64 %1{%6}, %4
+        vpaddq %2{%5}, %2, zmm15
+%endmacro
+
+p3np1Avx512:
+        push rbp
+        mov rbp, rsp
+
+        mov eax, 1
+        vpbroadcastq zmm15, rax
+
+.group:
+        test rdx, rdx
+        jz .done
+
+        vmovdqu64 zmm0, [rdi]
+        vmovdqu64 zmm1, [rdi+64]
+        vpxorq zmm2, zmm2, zmm2
+        vpxorq zmm3, zmm3, zmm3
+
+.loop:
+        STEP_AVX512 zmm0, zmm2, zmm4, zmm5, k1, k2
+        STEP_AVX512 zmm1, zmm3, zmm6, zmm7, k3, k4
+        STEP_AVX512 zmm0, zmm2, zmm4, zmm5, k1, k2
+        STEP_AVX512 zmm1, zmm3, zmm6, zmm7, k3, k4
+        STEP_AVX512 zmm0, zmm2, zmm4, zmm5, k1, k2
+        STEP_AVX512 zmm1, zmm3, zmm6, zmm7, k3, k4
+        STEP_AVX512 zmm0, zmm2, zmm4, zmm5, k1, k2
+        STEP_AVX512 zmm1, zmm3, zmm6, zmm7, k3, k4
+
+        kortestw k1, k3                 ; ZF: no lane of either vector ran the last step
+        jnz .loop
+
+        vmovdqu64 [rsi], zmm2
+        vmovdqu64 [rsi+64], zmm3
+
+        add rdi, 128
+        add rsi, 128
+        sub rdx, 16
+        jmp .group
+
+.done:
+        vzeroupper
+        pop rbp
+        ret
@@ -1,6 +1,24 @@
+section .data
+    align 16
+xtsPoly:                            ; Carries of a tweak doubling, as in aesENC.asm
+    dd 0x87, 0, 1, 0
+
 section .text
 global aes128DecryptBlock, aes256DecryptBlock, aesXtsDecrypt
 
+; Tweak doubling, %1 = %2 * x in GF(2^128), %3 scratch. %1 may be %2.
+%macro XTS_DOUBLE 3
+    vpsrad %3, %2, 31
+    vpaddq %1, %2, %2
+    vpshufd %3, %3, 0x13
+    vpand %3, %3, [rel xtsPoly]
+    vpxor %1, %1, %3
+%endmacro
+
+; The decryption schedules are those of the equivalent inverse cipher (FIPS 197, 5.3.5), kept in
+; encryption order: round keys 0 and Nr as they are, the ones between passed through vaesimc.
+
+; rdi = out, rsi = in, rdx = 176-byte AES-128 decryption schedule
 aes128DecryptBlock:
     vmovdqu xmm0, [rsi]             ; Load ciphertext
     vpxor xmm0, xmm0, [rdx+160]     ; AddRoundKey (start with round 10 key)
@@ -21,7 +39,8 @@ aes128DecryptBlock:
     ret
 
 ;; Ultra-intensive parallel AES decryption for maximum CPU stress
-;; rdi = output, rsi = input, rdx = round keys, r8 = block count
+;; XTS (IEEE 1619) with AES-256: rdi = output, rsi = input, rdx = 240-byte decryption schedule of
+;; the data key, rcx = first tweak (encrypted with the tweak key), r8 = block count
 aesXtsDecrypt:
     test r8, r8
     jz .done
@@ -42,11 +61,18 @@ aesXtsDecrypt:
     vmovdqu xmm13, [rsi+32]
     vmovdqu xmm14, [rsi+48]
 
+    ; Tweaks of the four blocks, and the first of the next four
+    vmovdqa xmm1, xmm15
+    XTS_DOUBLE xmm2, xmm1, xmm5
+    XTS_DOUBLE xmm3, xmm2, xmm5
+    XTS_DOUBLE xmm4, xmm3, xmm5
+    XTS_DOUBLE xmm15, xmm4, xmm5
+
     ; Apply initial tweak XOR
-    vpxor xmm11, xmm11, xmm15
-    vpxor xmm12, xmm12, xmm15
-    vpxor xmm13, xmm13, xmm15
-    vpxor xmm14, xmm14, xmm15
+    vpxor xmm11, xmm11, xmm1
+    vpxor xmm12, xmm12, xmm2
+    vpxor xmm13, xmm13, xmm3
+    vpxor xmm14, xmm14, xmm4
 
     ; Load round 14 key and apply (AES-256 decryption start)
     vmovdqu xmm0, [rdx+224]
@@ -142,10 +168,10 @@ aesXtsDecrypt:
     vaesdeclast xmm14, xmm14, xmm0
 
     ; Apply final tweak XOR
-    vpxor xmm11, xmm11, xmm15
-    vpxor xmm12, xmm12, xmm15
-    vpxor xmm13, xmm13, xmm15
-    vpxor xmm14, xmm14, xmm15
+    vpxor xmm11, xmm11, xmm1
+    vpxor xmm12, xmm12, xmm2
+    vpxor xmm13, xmm13, xmm3
+    vpxor xmm14, xmm14, xmm4
 
     ; Store results
     vmovdqu [rdi], xmm11
@@ -202,6 +228,7 @@ aesXtsDecrypt:
 
     vpxor xmm11, xmm11, xmm15    ; Apply final tweak
     vmovdqu [rdi], xmm11
+    XTS_DOUBLE xmm15, xmm15, xmm12
 
     add rsi, 16
     add rdi, 16
@@ -209,4 +236,4 @@ aesXtsDecrypt:
     jnz .remainingLoop
 
 .done:
-    ret
\ No newline at end of file
+    ret
@@ -1,7 +1,22 @@
+section .data
+    align 16
+xtsPoly:                            ; Carries of a tweak doubling: x^7 + x^2 + x + 1 out of bit 127,
+    dd 0x87, 0, 1, 0                ; and bit 63 into bit 64
+
 section .text
 global aes128EncryptBlock, aes256Keygen, aesXtsEncrypt
 
-
+; Tweak doubling, %1 = %2 * x mod x^128 + x^7 + x^2 + x + 1 (little-endian, as IEEE 1619 stores
+; it), %3 scratch. %1 may be %2.
+%macro XTS_DOUBLE 3
+    vpsrad %3, %2, 31               ; Sign of each dword
+    vpaddq %1, %2, %2               ; Each qword shifted left by one
+    vpshufd %3, %3, 0x13            ; Bit 127 to dword 0, bit 63 to dword 2
+    vpand %3, %3, [rel xtsPoly]
+    vpxor %1, %1, %3
+%endmacro
+
+; rdi = out, rsi = in, rdx = 176-byte AES-128 encryption schedule
 aes128EncryptBlock:
     vmovdqu xmm0, [rsi]             ; Load plaintext
     vpxor xmm0, xmm0, [rdx]         ; AddRoundKey (round 0)
@@ -21,81 +36,67 @@ aes128EncryptBlock:
     vmovdqu [rdi], xmm0
     ret
 
-; Optimized AES-256 key expansion
-; rdi = output buffer (240 bytes for 15 round keys), rdx = 32-byte master key
+; AES-256 key expansion (FIPS 197, 5.2)
+; rdi = output buffer (240 bytes for 15 round keys), rsi = 32-byte master key
+; Each new round key is the prefix XOR of the key two before it, plus one word derived from the
+; key just before it: RotWord(SubWord(w3)) xor Rcon for the even keys, SubWord(w3) for the odd ones.
+
+; xmm%1 = prefix XOR of its own four words, the w[i-8] xor w[i-7] xor ... chain; xmm3 scratch
+%macro KEY_PREFIX_XOR 1
+    vpslldq xmm3, xmm%1, 4
+    vpxor xmm%1, xmm%1, xmm3
+    vpslldq xmm3, xmm%1, 4
+    vpxor xmm%1, xmm%1, xmm3
+    vpslldq xmm3, xmm%1, 4
+    vpxor xmm%1, xmm%1, xmm3
+%endmacro
+
+; Even round key into xmm0 and [rdi+%2]: %1 = Rcon, broadcast by vpshufd to every word
+%macro KEY256_EVEN 2
+    vaeskeygenassist xmm2, xmm1, %1
+    vpshufd xmm2, xmm2, 0xFF        ; RotWord(SubWord(w3)) xor Rcon
+    KEY_PREFIX_XOR 0
+    vpxor xmm0, xmm0, xmm2
+    vmovdqu [rdi+%2], xmm0
+%endmacro
+
+; Odd round key into xmm1 and [rdi+%1]
+%macro KEY256_ODD 1
+    vaeskeygenassist xmm2, xmm0, 0
+    vpshufd xmm2, xmm2, 0xAA        ; SubWord(w3), no rotation or Rcon
+    KEY_PREFIX_XOR 1
+    vpxor xmm1, xmm1, xmm2
+    vmovdqu [rdi+%1], xmm1
+%endmacro
+
 aes256Keygen:
     ; Load master key
-    vmovdqu xmm0, [rdx]      ; First 16 bytes
-    vmovdqu xmm1, [rdx+16]   ; Second 16 bytes
+    vmovdqu xmm0, [rsi]      ; First 16 bytes
+    vmovdqu xmm1, [rsi+16]   ; Second 16 bytes
 
     ; Store initial round keys
     vmovdqu [rdi], xmm0      ; Round 0 key
     vmovdqu [rdi+16], xmm1   ; Round 1 key
 
-    ; Key expansion constants
-    mov r8d, 1               ; RCON value
-    mov r9, 32               ; Byte offset for storing keys
-    mov r10, 13              ; Remaining rounds to generate
-
-.keygenLoop:
-
-    test r10, 1
-    jz .evenRound
-
-.oddRound:
-    ; Pattern: SubWord(RotWord(W[i-1])) transformation with RCON
-    vaeskeygenassist xmm2, xmm1, 0
-    vpshufd xmm2, xmm2, 0xFF        ; Get the rotated/substituted value
-
-    ; Manually apply RCON to the first byte
-    vmovd xmm3, r8d
-    vpslldq xmm3, xmm3, 12          ; Move RCON to position
-    vpxor xmm2, xmm2, xmm3          ; Apply RCON
-
-    ; Key expansion transformation for xmm0
-    vpslldq xmm3, xmm0, 4           ; Shift left by 4 bytes
-    vpxor xmm0, xmm0, xmm3
-    vpslldq xmm3, xmm0, 4
-    vpxor xmm0, xmm0, xmm3
-    vpslldq xmm3, xmm0, 4
-    vpxor xmm0, xmm0, xmm3
-    vpxor xmm0, xmm0, xmm2          ; Final XOR with transformed value
-
-    ; Update RCON for next iteration
-    shl r8d, 1
-    cmp r8d, 0x80                   ; Handle RCON overflow
-    jne .storeOddKey
-    mov r8d, 0x1B                   ; Reset RCON with polynomial
-
-.storeOddKey:
-    vmovdqu [rdi + r9], xmm0
-    add r9, 16
-    dec r10
-    jz .keygenDone
-    jmp .evenRound
-
-.evenRound:
-    ; Pattern: SubWord(W[i-1]) transformation (no rotation, no RCON)
-    vaeskeygenassist xmm2, xmm0, 0
-    vpshufd xmm2, xmm2, 0xAA        ; Get SubWord result
-
-    ; Key expansion transformation for xmm1
-    vpslldq xmm3, xmm1, 4
-    vpxor xmm1, xmm1, xmm3
-    vpslldq xmm3, xmm1, 4
-    vpxor xmm1, xmm1, xmm3
-    vpslldq xmm3, xmm1, 4
-    vpxor xmm1, xmm1, xmm3
-    vpxor xmm1, xmm1, xmm2
-
-    vmovdqu [rdi + r9], xmm1
-    add r9, 16
-    dec r10
-    jnz .keygenLoop
-
-.keygenDone:
+    ; vaeskeygenassist takes Rcon as an immediate, so the seven steps are unrolled
+    KEY256_EVEN 0x01, 32
+    KEY256_ODD 48
+    KEY256_EVEN 0x02, 64
+    KEY256_ODD 80
+    KEY256_EVEN 0x04, 96
+    KEY256_ODD 112
+    KEY256_EVEN 0x08, 128
+    KEY256_ODD 144
+    KEY256_EVEN 0x10, 160
+    KEY256_ODD 176
+    KEY256_EVEN 0x20, 192
+    KEY256_ODD 208
+    KEY256_EVEN 0x40, 224
     ret
 
+; XTS (IEEE 1619) with AES-256: rdi = out, rsi = in, rdx = 240-byte encryption schedule of the
+; data key, rcx = first tweak (the data unit number already encrypted with the tweak key),
+; r8 = blocks. Block j is masked with tweak * x^j in GF(2^128).
 aesXtsEncrypt:
     test r8, r8
     jz .done
@@ -115,11 +116,18 @@ aesXtsEncrypt:
     vmovdqu xmm13, [rsi+32]
     vmovdqu xmm14, [rsi+48]
 
+    ; Tweaks of the four blocks, and the first of the next four
+    vmovdqa xmm1, xmm15
+    XTS_DOUBLE xmm2, xmm1, xmm5
+    XTS_DOUBLE xmm3, xmm2, xmm5
+    XTS_DOUBLE xmm4, xmm3, xmm5
+    XTS_DOUBLE xmm15, xmm4, xmm5
+
     ; Apply initial tweak XOR
-    vpxor xmm11, xmm11, xmm15
-    vpxor xmm12, xmm12, xmm15
-    vpxor xmm13, xmm13, xmm15
-    vpxor xmm14, xmm14, xmm15
+    vpxor xmm11, xmm11, xmm1
+    vpxor xmm12, xmm12, xmm2
+    vpxor xmm13, xmm13, xmm3
+    vpxor xmm14, xmm14, xmm4
 
     ; Load round 0 key and apply
     vmovdqu xmm0, [rdx]
@@ -215,10 +223,10 @@ aesXtsEncrypt:
     vaesenclast xmm14, xmm14, xmm0
 
     ; Apply final tweak XOR
-    vpxor xmm11, xmm11, xmm15
-    vpxor xmm12, xmm12, xmm15
-    vpxor xmm13, xmm13, xmm15
-    vpxor xmm14, xmm14, xmm15
+    vpxor xmm11, xmm11, xmm1
+    vpxor xmm12, xmm12, xmm2
+    vpxor xmm13, xmm13, xmm3
+    vpxor xmm14, xmm14, xmm4
 
     ; Store results
     vmovdqu [rdi], xmm11
@@ -276,6 +284,7 @@ aesXtsEncrypt:
 
     vpxor xmm11, xmm11, xmm15    ; Apply final tweak
     vmovdqu [rdi], xmm11
+    XTS_DOUBLE xmm15, xmm15, xmm12
 
     add rsi, 16
     add rdi, 16
@@ -283,4 +292,4 @@ aesXtsEncrypt:
     jnz .remainingLoop
 
 .done:
-    ret
\ No newline at end of file
+    ret
@@ -0,0 +1,239 @@
+global avx512
+section .text
+
+; AVX-512F variant of avx: the same waves on zmm registers. rdi/rsi/rdx point at 16 floats
+; each, so one call covers two avx calls' worth of data. 128-bit lane permutes stand in for
+; vperm2f128, the 14-bit rcp/rsqrt for vrcpps/vrsqrtps, and the blends and compares go
+; through mask registers.
+; Wave 13 keeps the upper half of the register file busy: zmm16-zmm23 are FMA accumulators
+; (half of them merge- or zero-masked), zmm24-zmm29 their multipliers, reshuffled every
+; iteration by full-width permutes indexed by zmm30/zmm31. The accumulators are folded
+; into the result, so they take part in the checked output.
+avx512:
+        push rbp
+        mov rbp, rsp
+
+        vmovups zmm0, [rdi]
+        vmovups zmm1, [rsi]
+        vmovups zmm2, [rdx]
+
+        vbroadcastss zmm3, dword [rdi]
+        vbroadcastss zmm4, dword [rsi+4]
+        vbroadcastss zmm5, dword [rdx+8]
+        vbroadcastss zmm6, dword [rdi+12]
+        vbroadcastss zmm7, dword [rsi+16]
+        vbroadcastss zmm8, dword [rdx+20]
+        vbroadcastss zmm9, dword [rdi+24]
+        vbroadcastss zmm10, dword [rsi+28]
+        vbroadcastss zmm11, dword [rdx+32]
+        vbroadcastss zmm12, dword [rdi+36]
+        vbroadcastss zmm13, dword [rsi+40]
+        vbroadcastss zmm14, dword [rdx+44]
+        vbroadcastss zmm15, dword [rdi+48]
+
+        ; Upper bank: accumulators, multipliers, permute indices (low 4-5 bits of each word)
+        vmovups zmm16, [rsi]
+        vmovups zmm17, [rdx]
+        vbroadcastss zmm18, dword [rdi+52]
+        vbroadcastss zmm19, dword [rsi+56]
+        vbroadcastss zmm20, dword [rdx+60]
+        vbroadcastss zmm21, dword [rdi+4]
+        vbroadcastss zmm22, dword [rsi+8]
+        vbroadcastss zmm23, dword [rdx+12]
+        vmovups zmm24, [rdx]
+        vmovups zmm25, [rdi]
+        vbroadcastss zmm26, dword [rdi+28]
+        vbroadcastss zmm27, dword [rsi+32]
+        vbroadcastss zmm28, dword [rdx+36]
+        vbroadcastss zmm29, dword [rdi+40]
+        vmovups zmm30, [rdi]
+        vmovups zmm31, [rsi]
+
+        ; Blend masks of wave 7, reused as FMA masks by wave 13
+        mov ecx, 0xAAAA
+        kmovw k1, ecx
+        mov ecx, 0x5555
+        kmovw k2, ecx
+        mov ecx, 0xF0F0
+        kmovw k3, ecx
+        mov ecx, 0x0F0F
+        kmovw k4, ecx
+        mov ecx, 0xCCCC
+        kmovw k5, ecx
+        mov ecx, 0x3333
+        kmovw k6, ecx
+
+        mov rax, 8192
+
+.loop:
+        ; === WAVE 1: FMA dependency chain ===
+        vfmadd132ps zmm0, zmm15, zmm14
+        vfmadd132ps zmm1, zmm0, zmm13
+        vfmadd132ps zmm2, zmm1, zmm12
+        vfmadd132ps zmm3, zmm2, zmm11
+        vfmadd132ps zmm4, zmm3, zmm10
+        vfmadd132ps zmm5, zmm4, zmm9
+        vfmadd132ps zmm6, zmm5, zmm8
+        vfmadd132ps zmm7, zmm6, zmm7
+
+        ; === WAVE 2: lane permutes + FMA ===
+        vshuff32x4 zmm8, zmm0, zmm1, 0x44
+        vshuff32x4 zmm9, zmm2, zmm3, 0xEE
+        vshuff32x4 zmm10, zmm4, zmm5, 0x4E
+        vshuff32x4 zmm11, zmm6, zmm7, 0xB1
+        vshufps zmm12, zmm8, zmm9, 0x88
+        vshufps zmm13, zmm10, zmm11, 0xDD
+        vfmadd231ps zmm14, zmm12, zmm13
+        vfmsub231ps zmm15, zmm8, zmm9
+
+        ; === WAVE 3: reciprocal / rsqrt approximations ===
+        vrcp14ps zmm0, zmm14
+        vrcp14ps zmm1, zmm15
+        vrcp14ps zmm2, zmm0
+        vrcp14ps zmm3, zmm1
+        vrsqrt14ps zmm4, zmm2
+        vrsqrt14ps zmm5, zmm3
+        vrsqrt14ps zmm6, zmm4
+        vrsqrt14ps zmm7, zmm5
+
+        ; Newton-Raphson refinement
+        vmulps zmm8, zmm0, zmm0
+        vmulps zmm9, zmm8, zmm14
+        vsubps zmm10, zmm9, zmm1
+        vmulps zmm11, zmm10, zmm0
+
+        ; === WAVE 4: division chain ===
+        vdivps zmm12, zmm11, zmm6
+        vdivps zmm13, zmm7, zmm12
+        vdivps zmm14, zmm4, zmm13
+        vdivps zmm15, zmm5, zmm14
+        vdivps zmm0, zmm15, zmm8
+        vdivps zmm1, zmm0, zmm9
+        vdivps zmm2, zmm1, zmm10
+        vdivps zmm3, zmm2, zmm11
+
+        ; === WAVE 5: mixed precision ===
+        vcvtps2pd zmm4, ymm3
+        vcvtpd2ps ymm5, zmm4
+        vinsertf64x4 zmm6, zmm6, ymm5, 1
+
+        ; === WAVE 6: integer index patterns ===
+        vpternlogd zmm7, zmm7, zmm7, 0xFF
+        vpsrld zmm8, zmm7, 25
+        vpslld zmm9, zmm8, 2
+
+        ; === WAVE 7: masked blends ===
+        vblendmps zmm10{k1}, zmm0, zmm1
+        vblendmps zmm11{k2}, zmm2, zmm3
+        vblendmps zmm12{k3}, zmm4, zmm6
+        vblendmps zmm13{k4}, zmm10, zmm11
+        vblendmps zmm14{k5}, zmm12, zmm13
+        vblendmps zmm15{k6}, zmm14, zmm0
+
+        ; === WAVE 8: maximum FMA saturation ===
+        vfmadd132ps zmm0, zmm15, zmm14
+        vfmadd213ps zmm1, zmm0, zmm13
+        vfmadd231ps zmm2, zmm1, zmm12
+        vfmsub132ps zmm3, zmm2, zmm11
+        vfmsub213ps zmm4, zmm3, zmm10
+        vfmsub231ps zmm5, zmm4, zmm9
+        vfnmadd132ps zmm6, zmm5, zmm8
+        vfnmadd213ps zmm7, zmm6, zmm7
+        vfnmadd231ps zmm8, zmm7, zmm6
+        vfnmsub132ps zmm9, zmm8, zmm5
+        vfnmsub213ps zmm10, zmm9, zmm4
+        vfnmsub231ps zmm11, zmm10, zmm3
+
+        ; === WAVE 9: alternating add/sub ===
+        vfmaddsub132ps zmm12, zmm11, zmm2
+        vfmsubadd132ps zmm13, zmm12, zmm1
+        vfmaddsub213ps zmm14, zmm13, zmm0
+        vfmsubadd213ps zmm15, zmm14, zmm15
+
+        ; === WAVE 10: compares into masks, blends on them ===
+        vcmpps k7, zmm12, zmm13, 0x01   ; LT
+        vpternlogd zmm0{k7}{z}, zmm0, zmm0, 0xFF
+        vcmpps k7, zmm14, zmm15, 0x02   ; LE
+        vpternlogd zmm1{k7}{z}, zmm1, zmm1, 0xFF
+        vcmpps k7, zmm0, zmm1, 0x04     ; NE
+        vpternlogd zmm2{k7}{z}, zmm2, zmm2, 0xFF
+        vcmpps k7, zmm2, zmm12, 0x08    ; EQ_UQ
+        vpternlogd zmm3{k7}{z}, zmm3, zmm3, 0xFF
+
+        vptestmd k7, zmm0, zmm0
+        vblendmps zmm4{k7}, zmm13, zmm14
+        vptestmd k7, zmm1, zmm1
+        vblendmps zmm5{k7}, zmm15, zmm12
+        vptestmd k7, zmm2, zmm2
+        vblendmps zmm6{k7}, zmm4, zmm5
+        vptestmd k7, zmm3, zmm3
+        vblendmps zmm7{k7}, zmm6, zmm3
+
+        ; === WAVE 11: polynomial ===
+        vmovaps zmm8, zmm7
+        vmulps zmm9, zmm8, zmm8
+        vmulps zmm10, zmm9, zmm8
+        vmulps zmm11, zmm10, zmm8
+        vmulps zmm12, zmm11, zmm8
+
+        vfmadd231ps zmm13, zmm8, [rdi]
+        vfmadd231ps zmm13, zmm9, [rsi]
+        vfmadd231ps zmm13, zmm10, [rdx]
+        vfmadd231ps zmm13, zmm11, [rdi]
+        vfmadd231ps zmm13, zmm12, [rsi]
+
+        ; === WAVE 12: final chain ===
+        vfmadd132ps zmm14, zmm13, zmm12
+        vfmsub132ps zmm15, zmm14, zmm11
+        vfnmadd132ps zmm0, zmm15, zmm10
+        vfnmsub132ps zmm1, zmm0, zmm9
+        vmulps zmm2, zmm1, zmm8
+        vdivps zmm3, zmm2, zmm7
+        vrcp14ps zmm4, zmm3
+        vsqrtps zmm5, zmm4
+
+        vaddps zmm6, zmm5, zmm0
+        vmulps zmm7, zmm6, zmm1
+        vsubps zmm8, zmm7, zmm2
+        vdivps zmm9, zmm8, zmm3
+
+        vmovaps zmm10, zmm9
+        vaddps zmm11, zmm10, zmm4
+        vmulps zmm12, zmm11, zmm5
+
+        ; === WAVE 13: upper bank, eight independent FMA chains ===
+        vfmadd231ps zmm16, zmm24, zmm25
+        vfmadd231ps zmm17{k1}, zmm25, zmm26
+        vfmsub231ps zmm18, zmm26, zmm27
+        vfmsub231ps zmm19{k2}, zmm27, zmm28
+        vfnmadd231ps zmm20, zmm28, zmm29
+        vfnmadd231ps zmm21{k3}{z}, zmm29, zmm24
+        vfmadd231ps zmm22, zmm24, zmm26
+        vfmadd231ps zmm23{k4}, zmm25, zmm27
+
+        ; Multipliers only move between lanes, so their magnitudes stay those of the inputs
+        vpermt2ps zmm24, zmm30, zmm25   ; 32-entry permute across both sources
+        vpermt2ps zmm26, zmm31, zmm27
+        vpermps zmm25, zmm31, zmm28
+        vpermps zmm27, zmm30, zmm29
+        vshuff32x4 zmm28, zmm28, zmm29, 0x4E
+        vpermilps zmm29, zmm29, 0x1B
+
+        dec rax
+        jnz .loop
+
+        vaddps zmm16, zmm16, zmm17
+        vaddps zmm18, zmm18, zmm19
+        vaddps zmm20, zmm20, zmm21
+        vaddps zmm22, zmm22, zmm23
+        vaddps zmm16, zmm16, zmm18
+        vaddps zmm20, zmm20, zmm22
+        vaddps zmm16, zmm16, zmm20
+
+        vaddps zmm0, zmm12, zmm0
+        vaddps zmm0, zmm0, zmm16
+        vmovups [rdi], zmm0
+        vzeroupper
+
+        pop rbp
+        ret
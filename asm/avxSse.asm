@@ -0,0 +1,276 @@
+global avxSse
+section .text
+
+; SSE4.2 variant of avx for CPUs without AVX: the same waves on xmm registers with legacy
+; encodings, each FMA split into a multiply and an add/sub.
+; Same interface as avx: rdi/rsi/rdx point at 8 floats each. They are processed as two
+; 4-float halves of 8192 iterations, so one call does the same arithmetic as one avx call.
+avxSse:
+        push rbp
+        mov rbp, rsp
+
+        xor r8, r8                      ; Byte offset of the current half
+
+.half:
+        movups xmm0, [rdi + r8]
+        movups xmm1, [rsi + r8]
+        movups xmm2, [rdx + r8]
+
+        ; Broadcast constants, as in avx
+        movss xmm3, [rdi]
+        shufps xmm3, xmm3, 0
+        movss xmm4, [rsi+4]
+        shufps xmm4, xmm4, 0
+        movss xmm5, [rdx+8]
+        shufps xmm5, xmm5, 0
+        movss xmm6, [rdi+12]
+        shufps xmm6, xmm6, 0
+        movss xmm7, [rsi+16]
+        shufps xmm7, xmm7, 0
+        movss xmm8, [rdx+20]
+        shufps xmm8, xmm8, 0
+        movss xmm9, [rdi+24]
+        shufps xmm9, xmm9, 0
+        movss xmm10, [rsi+28]
+        shufps xmm10, xmm10, 0
+        movss xmm11, [rdx+32]
+        shufps xmm11, xmm11, 0
+        movss xmm12, [rdi+36]
+        shufps xmm12, xmm12, 0
+        movss xmm13, [rsi+40]
+        shufps xmm13, xmm13, 0
+        movss xmm14, [rdx+44]
+        shufps xmm14, xmm14, 0
+        movss xmm15, [rdi+48]
+        shufps xmm15, xmm15, 0
+
+        mov rax, 8192
+
+.loop:
+        ; === WAVE 1: multiply-add dependency chain ===
+        mulps xmm0, xmm14
+        addps xmm0, xmm15
+        mulps xmm1, xmm13
+        addps xmm1, xmm0
+        mulps xmm2, xmm12
+        addps xmm2, xmm1
+        mulps xmm3, xmm11
+        addps xmm3, xmm2
+        mulps xmm4, xmm10
+        addps xmm4, xmm3
+        mulps xmm5, xmm9
+        addps xmm5, xmm4
+        mulps xmm6, xmm8
+        addps xmm6, xmm5
+        mulps xmm7, xmm7
+        addps xmm7, xmm6
+
+        ; === WAVE 2: shuffles + multiply-add ===
+        movaps xmm8, xmm0
+        shufps xmm8, xmm1, 0x44
+        movaps xmm9, xmm2
+        shufps xmm9, xmm3, 0xEE
+        movaps xmm10, xmm4
+        shufps xmm10, xmm5, 0x4E
+        movaps xmm11, xmm6
+        shufps xmm11, xmm7, 0xB1
+        movaps xmm12, xmm8
+        shufps xmm12, xmm9, 0x88
+        movaps xmm13, xmm10
+        shufps xmm13, xmm11, 0xDD
+        movaps xmm15, xmm12             ; xmm14 += xmm12 * xmm13, xmm15 is rewritten next
+        mulps xmm15, xmm13
+        addps xmm14, xmm15
+        movaps xmm15, xmm8              ; xmm15 = xmm8 * xmm9 - xmm11
+        mulps xmm15, xmm9
+        subps xmm15, xmm11
+
+        ; === WAVE 3: reciprocal / rsqrt approximations ===
+        rcpps xmm0, xmm14
+        rcpps xmm1, xmm15
+        rcpps xmm2, xmm0
+        rcpps xmm3, xmm1
+        rsqrtps xmm4, xmm2
+        rsqrtps xmm5, xmm3
+        rsqrtps xmm6, xmm4
+        rsqrtps xmm7, xmm5
+
+        ; Newton-Raphson refinement
+        movaps xmm8, xmm0
+        mulps xmm8, xmm0
+        movaps xmm9, xmm8
+        mulps xmm9, xmm14
+        movaps xmm10, xmm9
+        subps xmm10, xmm1
+        movaps xmm11, xmm10
+        mulps xmm11, xmm0
+
+        ; === WAVE 4: division chain ===
+        movaps xmm12, xmm11
+        divps xmm12, xmm6
+        movaps xmm13, xmm7
+        divps xmm13, xmm12
+        movaps xmm14, xmm4
+        divps xmm14, xmm13
+        movaps xmm15, xmm5
+        divps xmm15, xmm14
+        movaps xmm0, xmm15
+        divps xmm0, xmm8
+        movaps xmm1, xmm0
+        divps xmm1, xmm9
+        movaps xmm2, xmm1
+        divps xmm2, xmm10
+        movaps xmm3, xmm2
+        divps xmm3, xmm11
+
+        ; === WAVE 5: mixed precision ===
+        cvtps2pd xmm4, xmm3
+        cvtpd2ps xmm5, xmm4
+        movlhps xmm6, xmm5
+
+        ; === WAVE 6: integer index patterns ===
+        pcmpeqd xmm7, xmm7
+        movdqa xmm8, xmm7
+        psrld xmm8, 25
+        movdqa xmm9, xmm8
+        pslld xmm9, 2
+
+        ; === WAVE 7: blends ===
+        movaps xmm10, xmm0
+        blendps xmm10, xmm1, 0xA
+        movaps xmm11, xmm2
+        blendps xmm11, xmm3, 0x5
+        movaps xmm12, xmm4
+        blendps xmm12, xmm6, 0xC
+        movaps xmm13, xmm10
+        blendps xmm13, xmm11, 0x3
+        movaps xmm14, xmm12
+        blendps xmm14, xmm13, 0xC
+        movaps xmm15, xmm14
+        blendps xmm15, xmm0, 0x3
+
+        ; === WAVE 8: multiply-add saturation ===
+        mulps xmm0, xmm14
+        addps xmm0, xmm15
+        mulps xmm1, xmm0
+        addps xmm1, xmm13
+        mulps xmm2, xmm1
+        addps xmm2, xmm12
+        mulps xmm3, xmm11
+        subps xmm3, xmm2
+        mulps xmm4, xmm3
+        subps xmm4, xmm10
+        mulps xmm5, xmm4
+        subps xmm5, xmm9
+        mulps xmm6, xmm8
+        subps xmm6, xmm5
+        mulps xmm7, xmm6
+        addps xmm7, xmm15
+        mulps xmm8, xmm7
+        subps xmm8, xmm6
+        mulps xmm9, xmm5
+        subps xmm9, xmm8
+        mulps xmm10, xmm9
+        subps xmm10, xmm4
+        mulps xmm11, xmm10
+        subps xmm11, xmm3
+
+        ; === WAVE 9: alternating add/sub ===
+        mulps xmm12, xmm2
+        addsubps xmm12, xmm11
+        mulps xmm13, xmm1
+        addsubps xmm13, xmm12
+        mulps xmm14, xmm13
+        addsubps xmm14, xmm0
+        mulps xmm15, xmm14
+        addsubps xmm15, xmm14
+
+        ; === WAVE 10: compares + variable blends (blendvps takes its mask in xmm0) ===
+        movaps xmm0, xmm12
+        cmpps xmm0, xmm13, 1            ; LT
+        movaps xmm1, xmm14
+        cmpps xmm1, xmm15, 2            ; LE
+        movaps xmm2, xmm0
+        cmpps xmm2, xmm1, 4             ; NE
+        movaps xmm3, xmm2
+        cmpps xmm3, xmm12, 5            ; NLT
+
+        movaps xmm4, xmm13
+        blendvps xmm4, xmm14, xmm0
+        movaps xmm5, xmm15
+        blendvps xmm5, xmm12, xmm0
+        movaps xmm6, xmm4
+        blendvps xmm6, xmm5, xmm0
+        movaps xmm7, xmm6
+        blendvps xmm7, xmm3, xmm0
+
+        ; === WAVE 11: polynomial, xmm2 is free until wave 12 ===
+        movaps xmm8, xmm7
+        movaps xmm9, xmm8
+        mulps xmm9, xmm8
+        movaps xmm10, xmm9
+        mulps xmm10, xmm8
+        movaps xmm11, xmm10
+        mulps xmm11, xmm8
+        movaps xmm12, xmm11
+        mulps xmm12, xmm8
+
+        movups xmm2, [rdi + r8]
+        mulps xmm2, xmm8
+        addps xmm13, xmm2
+        movups xmm2, [rsi + r8]
+        mulps xmm2, xmm9
+        addps xmm13, xmm2
+        movups xmm2, [rdx + r8]
+        mulps xmm2, xmm10
+        addps xmm13, xmm2
+        movups xmm2, [rdi + r8]
+        mulps xmm2, xmm11
+        addps xmm13, xmm2
+        movups xmm2, [rsi + r8]
+        mulps xmm2, xmm12
+        addps xmm13, xmm2
+
+        ; === WAVE 12: final chain ===
+        mulps xmm14, xmm12
+        addps xmm14, xmm13
+        mulps xmm15, xmm11
+        subps xmm15, xmm14
+        mulps xmm0, xmm10
+        subps xmm0, xmm15
+        mulps xmm1, xmm9
+        subps xmm1, xmm0
+        movaps xmm2, xmm1
+        mulps xmm2, xmm8
+        movaps xmm3, xmm2
+        divps xmm3, xmm7
+        rcpps xmm4, xmm3
+        sqrtps xmm5, xmm4
+
+        movaps xmm6, xmm5
+        addps xmm6, xmm0
+        movaps xmm7, xmm6
+        mulps xmm7, xmm1
+        movaps xmm8, xmm7
+        subps xmm8, xmm2
+        movaps xmm9, xmm8
+        divps xmm9, xmm3
+
+        movaps xmm10, xmm9
+        movaps xmm11, xmm10
+        addps xmm11, xmm4
+        movaps xmm12, xmm11
+        mulps xmm12, xmm5
+
+        dec rax
+        jnz .loop
+
+        addps xmm0, xmm12
+        movups [rdi + r8], xmm0
+
+        add r8, 16
+        cmp r8, 32
+        jb .half
+
+        pop rbp
+        ret
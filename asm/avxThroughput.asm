@@ -0,0 +1,228 @@
+global avxThroughputSse
+global avxThroughput
+global avx512Throughput
+section .text
+
+; Throughput-bound counterparts of avx: only independent accumulator chains, enough of them
+; (latency x ports, with headroom) that every FP port issues each cycle instead of waiting
+; on the previous result as the waves of avx do. Same interface as the matching avx variant;
+; the accumulators are summed into [rdi] so the result stays live and checkable.
+
+; SSE4.2: no FMA, so six add chains and six multiply chains (by -1.0, so nothing over- or
+; underflows) share the two FP ports. rdi/rsi/rdx point at 8 floats each.
+avxThroughputSse:
+        push rbp
+        mov rbp, rsp
+
+        movups xmm0, [rdi]
+        movups xmm1, [rdi+16]
+        movups xmm2, [rsi]
+        movups xmm3, [rsi+16]
+        movups xmm4, [rdx]
+        movups xmm5, [rdx+16]
+        movups xmm6, [rdi]
+        movups xmm7, [rdi+16]
+        movups xmm8, [rsi]
+        movups xmm9, [rsi+16]
+        movups xmm10, [rdx]
+        movups xmm11, [rdx+16]
+        movups xmm12, [rsi]                ; Addends: products of the inputs
+        movups xmm13, [rdx]
+        mulps xmm12, xmm13
+        movups xmm14, [rsi+16]
+        movups xmm13, [rdx+16]
+        mulps xmm14, xmm13
+        pcmpeqd xmm13, xmm13               ; -1.0f: 0xbf800000
+        pslld xmm13, 25
+        psrld xmm13, 2
+        pcmpeqd xmm15, xmm15
+        pslld xmm15, 31
+        por xmm13, xmm15
+
+        mov rax, 65536
+
+.sse_loop:
+        addps xmm0, xmm12
+        addps xmm1, xmm14
+        addps xmm2, xmm12
+        addps xmm3, xmm14
+        addps xmm4, xmm12
+        addps xmm5, xmm14
+        mulps xmm6, xmm13
+        mulps xmm7, xmm13
+        mulps xmm8, xmm13
+        mulps xmm9, xmm13
+        mulps xmm10, xmm13
+        mulps xmm11, xmm13
+        dec rax
+        jnz .sse_loop
+
+        addps xmm0, xmm2
+        addps xmm1, xmm3
+        addps xmm0, xmm4
+        addps xmm1, xmm5
+        addps xmm6, xmm8
+        addps xmm7, xmm9
+        addps xmm6, xmm10
+        addps xmm7, xmm11
+        addps xmm0, xmm6
+        addps xmm1, xmm7
+        movups [rdi], xmm0
+        movups [rdi+16], xmm1
+
+        pop rbp
+        ret
+
+; AVX2+FMA: twelve FMA chains, ymm12-ymm15 hold the factors. rdi/rsi/rdx point at 8 floats each.
+avxThroughput:
+        push rbp
+        mov rbp, rsp
+
+        vmovups ymm0, [rdi]
+        vmovups ymm1, [rsi]
+        vmovups ymm2, [rdx]
+        vbroadcastss ymm3, dword [rdi+12]
+        vbroadcastss ymm4, dword [rsi+16]
+        vbroadcastss ymm5, dword [rdx+20]
+        vbroadcastss ymm6, dword [rdi+24]
+        vbroadcastss ymm7, dword [rsi+28]
+        vbroadcastss ymm8, dword [rdx+0]
+        vbroadcastss ymm9, dword [rdi+4]
+        vbroadcastss ymm10, dword [rsi+8]
+        vbroadcastss ymm11, dword [rdx+12]
+        vmovups ymm12, [rsi]
+        vmovups ymm13, [rdx]
+        vbroadcastss ymm14, dword [rdi+4]
+        vbroadcastss ymm15, dword [rsi+8]
+
+        mov rax, 65536
+
+.avx2_loop:
+        vfmadd231ps ymm0, ymm12, ymm13
+        vfmadd231ps ymm1, ymm14, ymm15
+        vfmadd231ps ymm2, ymm12, ymm14
+        vfmadd231ps ymm3, ymm13, ymm15
+        vfmadd231ps ymm4, ymm12, ymm13
+        vfmadd231ps ymm5, ymm14, ymm15
+        vfmadd231ps ymm6, ymm12, ymm14
+        vfmadd231ps ymm7, ymm13, ymm15
+        vfmadd231ps ymm8, ymm12, ymm13
+        vfmadd231ps ymm9, ymm14, ymm15
+        vfmadd231ps ymm10, ymm12, ymm14
+        vfmadd231ps ymm11, ymm13, ymm15
+        dec rax
+        jnz .avx2_loop
+
+        vaddps ymm0, ymm0, ymm1
+        vaddps ymm2, ymm2, ymm3
+        vaddps ymm4, ymm4, ymm5
+        vaddps ymm6, ymm6, ymm7
+        vaddps ymm8, ymm8, ymm9
+        vaddps ymm10, ymm10, ymm11
+        vaddps ymm0, ymm0, ymm2
+        vaddps ymm4, ymm4, ymm6
+        vaddps ymm8, ymm8, ymm10
+        vaddps ymm0, ymm0, ymm4
+        vaddps ymm0, ymm0, ymm8
+        vmovups [rdi], ymm0
+        vzeroupper
+
+        pop rbp
+        ret
+
+; AVX-512F: 24 FMA chains, zmm24-zmm31 hold the factors. rdi/rsi/rdx point at 16 floats each.
+avx512Throughput:
+        push rbp
+        mov rbp, rsp
+
+        vmovups zmm0, [rdi]
+        vmovups zmm1, [rsi]
+        vmovups zmm2, [rdx]
+        vbroadcastss zmm3, dword [rdi+12]
+        vbroadcastss zmm4, dword [rsi+16]
+        vbroadcastss zmm5, dword [rdx+20]
+        vbroadcastss zmm6, dword [rdi+24]
+        vbroadcastss zmm7, dword [rsi+28]
+        vbroadcastss zmm8, dword [rdx+32]
+        vbroadcastss zmm9, dword [rdi+36]
+        vbroadcastss zmm10, dword [rsi+40]
+        vbroadcastss zmm11, dword [rdx+44]
+        vbroadcastss zmm12, dword [rdi+48]
+        vbroadcastss zmm13, dword [rsi+52]
+        vbroadcastss zmm14, dword [rdx+56]
+        vbroadcastss zmm15, dword [rdi+60]
+        vbroadcastss zmm16, dword [rsi+0]
+        vbroadcastss zmm17, dword [rdx+4]
+        vbroadcastss zmm18, dword [rdi+8]
+        vbroadcastss zmm19, dword [rsi+12]
+        vbroadcastss zmm20, dword [rdx+16]
+        vbroadcastss zmm21, dword [rdi+20]
+        vbroadcastss zmm22, dword [rsi+24]
+        vbroadcastss zmm23, dword [rdx+28]
+        vmovups zmm24, [rsi]
+        vmovups zmm25, [rdx]
+        vmovups zmm26, [rdi]
+        vbroadcastss zmm27, dword [rdi+28]
+        vbroadcastss zmm28, dword [rsi+48]
+        vbroadcastss zmm29, dword [rdx+4]
+        vbroadcastss zmm30, dword [rdi+24]
+        vbroadcastss zmm31, dword [rsi+44]
+
+        mov rax, 65536
+
+.avx512_loop:
+        vfmadd231ps zmm0, zmm24, zmm25
+        vfmadd231ps zmm1, zmm26, zmm27
+        vfmadd231ps zmm2, zmm28, zmm29
+        vfmadd231ps zmm3, zmm30, zmm31
+        vfmadd231ps zmm4, zmm24, zmm26
+        vfmadd231ps zmm5, zmm25, zmm27
+        vfmadd231ps zmm6, zmm28, zmm30
+        vfmadd231ps zmm7, zmm29, zmm31
+        vfmadd231ps zmm8, zmm24, zmm25
+        vfmadd231ps zmm9, zmm26, zmm27
+        vfmadd231ps zmm10, zmm28, zmm29
+        vfmadd231ps zmm11, zmm30, zmm31
+        vfmadd231ps zmm12, zmm24, zmm26
+        vfmadd231ps zmm13, zmm25, zmm27
+        vfmadd231ps zmm14, zmm28, zmm30
+        vfmadd231ps zmm15, zmm29, zmm31
+        vfmadd231ps zmm16, zmm24, zmm25
+        vfmadd231ps zmm17, zmm26, zmm27
+        vfmadd231ps zmm18, zmm28, zmm29
+        vfmadd231ps zmm19, zmm30, zmm31
+        vfmadd231ps zmm20, zmm24, zmm26
+        vfmadd231ps zmm21, zmm25, zmm27
+        vfmadd231ps zmm22, zmm28, zmm30
+        vfmadd231ps zmm23, zmm29, zmm31
+        dec rax
+        jnz .avx512_loop
+
+        vaddps zmm0, zmm0, zmm1
+        vaddps zmm2, zmm2, zmm3
+        vaddps zmm4, zmm4, zmm5
+        vaddps zmm6, zmm6, zmm7
+        vaddps zmm8, zmm8, zmm9
+        vaddps zmm10, zmm10, zmm11
+        vaddps zmm12, zmm12, zmm13
+        vaddps zmm14, zmm14, zmm15
+        vaddps zmm16, zmm16, zmm17
+        vaddps zmm18, zmm18, zmm19
+        vaddps zmm20, zmm20, zmm21
+        vaddps zmm22, zmm22, zmm23
+        vaddps zmm0, zmm0, zmm2
+        vaddps zmm4, zmm4, zmm6
+        vaddps zmm8, zmm8, zmm10
+        vaddps zmm12, zmm12, zmm14
+        vaddps zmm16, zmm16, zmm18
+        vaddps zmm20, zmm20, zmm22
+        vaddps zmm0, zmm0, zmm4
+        vaddps zmm8, zmm8, zmm12
+        vaddps zmm16, zmm16, zmm20
+        vaddps zmm0, zmm0, zmm8
+        vaddps zmm0, zmm0, zmm16
+        vmovups [rdi], zmm0
+        vzeroupper
+
+        pop rbp
+        ret
@@ -9,6 +9,9 @@ section .data
 section .text
     global diskWrite
 
+; diskWrite(const char* name, const volatile uint32_t* stop)
+; rdi = file name, rsi = optional stop flag polled after every 256KB burst (NULL = never stop)
+; Returns the number of bytes written in rax.
 diskWrite:
     push rbp
     push r12
@@ -17,11 +20,14 @@ diskWrite:
     push r15
     push rbx
     mov rbp, rsp
+    sub rsp, 8                  ; [rbp-8] = bytes written
 
     mov r15, rdi                ; Save filename
+    mov r14, rsi                ; Save stop flag
+    mov qword [rbp-8], 0
 
     ; Create and write to file multiple times with different patterns
-    mov rbx, 8                  ; Number of write cycles (8 * 2GB = 16GB total I/O)
+    mov rbx, 4                  ; Number of write cycles (4 * 256MB = 1GB per call, callers loop)
 
 .cycle_loop:
     ; sys_open - create new file each cycle for more I/O stress
@@ -35,8 +41,9 @@ diskWrite:
     jl .next_cycle
     mov r12, rax                ; Save fd
 
-    ; Write 2GB with alternating buffer patterns
-    mov r13, 8192               ; 8192 * 4 buffers * 64KB = 2GB per cycle
+    ; Write 256MB with alternating buffer patterns; smaller files keep the
+    ; close+unlink after a stop request short
+    mov r13, 1024               ; 1024 * 4 buffers * 64KB = 256MB per cycle
 
 .write_loop:
     ; Write buffer1 (0xAA pattern)
@@ -75,6 +82,15 @@ diskWrite:
     cmp rax, 65536
     jne .close_file
 
+    add qword [rbp-8], 262144   ; 4 * 64KB burst done
+
+    ; Cooperative stop between bursts
+    test r14, r14
+    jz .no_stop
+    cmp dword [r14], 0
+    jne .close_file
+.no_stop:
+
     dec r13
     jnz .write_loop
 
@@ -90,9 +106,17 @@ diskWrite:
     syscall
 
 .next_cycle:
+    test r14, r14
+    jz .next_cycle_go
+    cmp dword [r14], 0
+    jne .finished
+.next_cycle_go:
     dec rbx
     jnz .cycle_loop
 
+.finished:
+    mov rax, [rbp-8]            ; bytes written
+
     ; Final cleanup
     mov rsp, rbp
     pop rbx
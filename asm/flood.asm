@@ -1,9 +1,64 @@
 section .text
 global floodL1L2, floodMemory, rowhammerAttack, floodNt
 
+; All four kernels share the same contract:
+;   rdi = buffer, rsi = pointer to pass count, rdx = buffer size,
+;   rcx = optional stop flag (const volatile uint32_t*), polled between passes and every
+;         SWEEP_POLL_INTERVAL loop iterations inside a sweep (NULL = never stop)
+; and return the number of passes actually completed in rax.
+
+SWEEP_POLL_INTERVAL equ 4096
+
+; Saves the callee-saved registers the kernels use, moves the stop flag out of rcx into rsi
+; and loads the pass count into rcx. rbx counts completed passes, r14d counts down to the next poll.
+%macro FLOOD_PROLOGUE 0
+    push rbx
+    push r12
+    push r13
+    push r14
+    mov rax, rcx
+    mov rcx, [rsi]            ; iterations count
+    mov rsi, rax              ; stop flag
+    xor rbx, rbx              ; completed passes
+    mov r14d, SWEEP_POLL_INTERVAL
+%endmacro
+
+; Polls the stop flag every SWEEP_POLL_INTERVAL iterations of a sweep loop and abandons
+; the current pass through %1 once it is raised.
+%macro FLOOD_POLL_SWEEP 1
+    dec r14d
+    jnz %%running
+    mov r14d, SWEEP_POLL_INTERVAL
+    test rsi, rsi
+    jz %%running
+    cmp dword [rsi], 0
+    jne %1
+%%running:
+%endmacro
+
+; Counts a finished pass and leaves through %1 once the stop flag is raised.
+%macro FLOOD_POLL_STOP 1
+    inc rbx
+    test rsi, rsi
+    jz %%running
+    cmp dword [rsi], 0
+    jne %1
+%%running:
+%endmacro
+
+%macro FLOOD_EPILOGUE 0
+    sfence
+    mov rax, rbx
+    pop r14
+    pop r13
+    pop r12
+    pop rbx
+    ret
+%endmacro
+
 ; Intensive L1/L2 cache flooding with multiple access patterns
 floodL1L2:
-    mov rcx, [rsi]            ; iterations count (second argument)
+    FLOOD_PROLOGUE
     mov r8, rdi             ; save original buffer pointer
     lea r9, [rdi + rdx]     ; end pointer
     mov rax, 0xdeadbeefcafebabe
@@ -47,20 +102,23 @@ floodL1L2:
     mov [r13], rax
 
 .nextIter:
+    FLOOD_POLL_SWEEP .cacheDone
     add rdi, 192            ; Large stride to thrash cache
     cmp rdi, r9
     jb .cacheLoop
 
     ; Reset pointer and continue
     mov rdi, r8
+    FLOOD_POLL_STOP .cacheDone
     dec rcx
     jnz .cacheLoop
 
-    ret
+.cacheDone:
+    FLOOD_EPILOGUE
 
 ; Intensive memory flooding with multiple access patterns
 floodMemory:
-    mov rcx, [rsi]            ; iterations count
+    FLOOD_PROLOGUE
     mov r8, rdi             ; save original pointer
     lea r9, [rdi + rdx]     ; end pointer
     mov rax, 0xbaadf00dcafebabe
@@ -83,6 +141,7 @@ floodMemory:
     mov [r12 + 48], rax
     mov [r12 + 56], r10
     add r12, 256
+    FLOOD_POLL_SWEEP .memoryDone
     jmp .burst1
 
 .burst2:
@@ -95,31 +154,36 @@ floodMemory:
     xor r13, rax
     mov [r12], r13
     add r12, 128
+    FLOOD_POLL_SWEEP .memoryDone
     jmp .rmw_loop
 
 .burst3:
     ; Non-temporal + regular stores mixed
     mov r12, rdi
 .mixed_loop:
-    cmp r12, r9
-    jae .nextMemIter
+    lea r13, [r12 + 192]    ; the whole 192-byte group must fit in the buffer
+    cmp r13, r9
+    ja .nextMemIter
     movnti [r12], rax
     mov [r12 + 64], r10
     movnti [r12 + 128], r11
     add r12, 192
+    FLOOD_POLL_SWEEP .memoryDone
     jmp .mixed_loop
 
 .nextMemIter:
     sfence
     mov rdi, r8             ; reset pointer
+    FLOOD_POLL_STOP .memoryDone
     dec rcx
     jnz .memoryLoop
 
-    ret
+.memoryDone:
+    FLOOD_EPILOGUE
 
 ; Aggressive rowhammer with multiple targets and patterns
 rowhammerAttack:
-    mov rcx, [rsi]            ; iterations count
+    FLOOD_PROLOGUE
     mov r8, rdx             ; buffer_size
     shr r8, 2               ; Quarter buffer for multiple targets
 
@@ -167,14 +231,16 @@ rowhammerAttack:
     pause
     pause
 
+    FLOOD_POLL_STOP .rhDone
     dec rcx
     jnz .rhLoop
 
-    ret
+.rhDone:
+    FLOOD_EPILOGUE
 
 ; Intensive non-temporal flooding with streaming patterns
 floodNt:
-    mov rcx, [rsi]            ; iterations count
+    FLOOD_PROLOGUE
     mov r8, rdi             ; save original pointer
     lea r9, [rdi + rdx]     ; end pointer
 
@@ -199,19 +265,22 @@ floodNt:
     movnti [r13 + 48], r11
     movnti [r13 + 56], r12
     add r13, 256
+    FLOOD_POLL_SWEEP .ntDone
     jmp .stream1
 
 .stream2:
     ; Streaming pattern 2: Interleaved with regular stores
     mov r13, rdi
 .interleaved:
-    cmp r13, r9
-    jae .stream3
+    lea rdx, [r13 + 256]    ; stores reach r13 + 200, keep them inside the buffer
+    cmp rdx, r9
+    ja .stream3
     movnti [r13], rax
     mov [r13 + 64], r10     ; Regular store to create pressure
     movnti [r13 + 128], r11
     mov [r13 + 192], r12    ; Regular store
     add r13, 320
+    FLOOD_POLL_SWEEP .ntDone
     jmp .interleaved
 
 .stream3:
@@ -223,12 +292,15 @@ floodNt:
     jb .ntNext
     movnti [r13], rax
     sub r13, 128
+    FLOOD_POLL_SWEEP .ntDone
     jmp .reverse
 
 .ntNext:
     sfence                  ; Ensure all NT stores complete
     mov rdi, r8             ; reset pointer
+    FLOOD_POLL_STOP .ntDone
     dec rcx
     jnz .ntLoop
 
-    ret
\ No newline at end of file
+.ntDone:
+    FLOOD_EPILOGUE
\ No newline at end of file
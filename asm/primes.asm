@@ -29,6 +29,7 @@ primes:
 
 .start_factorization:
     mov r12, rdi                    ; Number to factor
+    mov r13, 2                      ; First trial divisor
 
 .factorization_loop:
     ; === TRIAL DIVISION WITH EXTREME OPTIMIZATION RESISTANCE ===
@@ -289,12 +290,13 @@ primes:
 
 .sqrt_loop:
     mov rcx, rax
-    add rax, rdi
+    mov rax, rdi
+    xor rdx, rdx
+    div rcx
+    add rax, rcx
     shr rax, 1                      ; (rax + rdi/rax) / 2
     cmp rax, rcx
-    jb .sqrt_loop
-
-    mov rcx, rax                    ; sqrt(n)
+    jb .sqrt_loop                   ; rcx = floor(sqrt(n)) once the estimate stops falling
 
 .trial_division:
     cmp rbx, rcx
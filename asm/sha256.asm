@@ -1,7 +1,10 @@
 ; SHA-256 CPU Stress Test - NASM Syntax (PIC Compliant)
-; Function: sha_stress(uint64_t iterations)
-; Argument: RDI = number of iterations to run
-; No return value - just pure CPU punishment
+; Function: sha256(uint64_t iterations, const volatile uint32_t* stop, uint32_t* digest)
+; Arguments: RDI = number of iterations to run
+;            RSI = optional stop flag, polled between iterations (NULL = run to completion)
+;            RDX = optional 16-dword digest; each iteration's final states are added into it
+;                  lane-wise (NULL = no digest)
+; Returns: RAX = iterations actually completed
 section .data
     align 64
 stress_data:
@@ -61,6 +64,8 @@ sha256:
 
 .start_stress:
     mov r15, rdi        ; r15 = iteration counter
+    mov [rsp], rdi      ; requested iterations, to report how many completed
+    mov r9, rdx         ; r9 = digest (rdx is clobbered by mul below)
 
     ; Load constants using RIP-relative addressing
     movdqa xmm14, [rel bswap_shuf]  ; Byte swap mask
@@ -163,9 +168,36 @@ sha256:
     paddd xmm4, [r14] ; This is valid, r14 holds the address
     sha256rnds2 xmm0, xmm1
 
+    ; Fold this iteration's states into the digest
+    test r9, r9
+    jz .no_digest
+    movdqu xmm8, [r9]
+    paddd xmm8, xmm0
+    movdqu [r9], xmm8
+    movdqu xmm8, [r9 + 16]
+    paddd xmm8, xmm1
+    movdqu [r9 + 16], xmm8
+    movdqu xmm8, [r9 + 32]
+    paddd xmm8, xmm2
+    movdqu [r9 + 32], xmm8
+    movdqu xmm8, [r9 + 48]
+    paddd xmm8, xmm3
+    movdqu [r9 + 48], xmm8
+.no_digest:
+
     ; Decrement and continue
     dec r15
-    jnz .mega_loop
+    jz .finish
+
+    ; Cooperative stop: poll the shared flag between iterations
+    test rsi, rsi
+    jz .mega_loop
+    cmp dword [rsi], 0
+    je .mega_loop
+
+.finish:
+    mov rax, [rsp]
+    sub rax, r15        ; completed iterations
 
     ; Epilogue
     add rsp, 128
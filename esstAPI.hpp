@@ -5,21 +5,22 @@ using namespace std;
 extern "C" {
 #endif
 
-    void sha256(long iterations);
+    long sha256(long iterations, const volatile unsigned * stop = nullptr);
     void initGPU(int iterations);
     void p3np1E(unsigned long a, unsigned long * steps);
     void primes(unsigned long a, unsigned long * steps);
     void avx(float * a, float * b, float * c);
-    void floodL1L2(void* buffer, unsigned long * iterations_ptr, size_t buffer1_size);
-    void floodMemory(void* buffer, unsigned long * iterations_ptr, size_t buffer_size);
-    void rowhammerAttack(void* buffer, unsigned long * iterations_ptr, size_t buffer_size);
-    void floodNt(void * buffer, unsigned long * iterations_ptr, size_t buffer_size);
+    unsigned long floodL1L2(void* buffer, unsigned long * iterations_ptr, size_t buffer1_size, const volatile unsigned * stop = nullptr);
+    unsigned long floodMemory(void* buffer, unsigned long * iterations_ptr, size_t buffer_size, const volatile unsigned * stop = nullptr);
+    unsigned long rowhammerAttack(void* buffer, unsigned long * iterations_ptr, size_t buffer_size, const volatile unsigned * stop = nullptr);
+    unsigned long floodNt(void * buffer, unsigned long * iterations_ptr, size_t buffer_size, const volatile unsigned * stop = nullptr);
     void aes128EncryptBlock(void * out, const void * in, const void * key);
     void aes256Keygen(void* expanded_key);
     void aesXtsEncrypt(void * out, const void * in, const void* key, const void * tweak, size_t blocks);
     void aes128DecryptBlock(void * out, const void * in, const void * key);
     void aesXtsDecrypt(void * out, const void * in, const void* key, const void * tweak, size_t blocks);
     void startLZMA(int duration);
+    double startLZMAPartition(int duration, unsigned threads, unsigned first_core);
     void spawn_system_monitor();
     void stop_system_monitor();
 //
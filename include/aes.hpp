@@ -0,0 +1,70 @@
+#pragma once
+#include "cpuDispatch.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// AES-128 and AES-256 (FIPS 197) on AES-NI with AVX (CpuDispatch::Aes::AesNiVex): key expansion
+// into both round-key schedules, and the ECB, CTR (SP 800-38A) and XTS (IEEE 1619, whole blocks)
+// modes. The modes keep eight independent blocks in flight, so each vaesenc issues while the ones
+// before it are still in the pipeline instead of waiting out its latency. CTR and XTS also run on
+// VAES, eight ymm or zmm registers of two or four blocks each, 16 or 32 blocks in flight, for the
+// same output. AES-GCM (SP 800-38D) stitches that CTR to GHASH, the carry-less multiplies of a
+// group summed unreduced and folded back into GF(2^128) once per group. selfTest() checks every
+// engine the CPU runs, and the asm entry points of core.hpp, against the published known answers.
+class Aes {
+public:
+    using Engine = CpuDispatch::Aes;
+    using GcmEngine = CpuDispatch::Gcm;
+    static constexpr size_t BLOCK = 16;
+    static constexpr unsigned MAX_ROUNDS = 14;
+    static constexpr size_t GCM_IV_BYTES = 12;
+    static constexpr size_t GCM_POWERS = 32; // hash key powers, one per block of the widest group
+    enum class Direction { Encrypt, Decrypt };
+
+    // Round keys 0 to rounds. The decryption schedule is the equivalent inverse cipher's in the same
+    // order, the keys between the first and the last through InvMixColumns, as aesDEC.asm takes it.
+    struct Key {
+        alignas(16) uint8_t encrypt[MAX_ROUNDS + 1][BLOCK];
+        alignas(16) uint8_t decrypt[MAX_ROUNDS + 1][BLOCK];
+        unsigned rounds = 0; // 10 for AES-128, 14 for AES-256
+    };
+
+    // The cipher key and the GHASH key H = E(0): powers[i] is H^(GCM_POWERS - i), byte-reflected,
+    // so a group of n blocks multiplies by the last n from its first block on.
+    struct GcmKey {
+        Key key;
+        alignas(64) uint8_t powers[GCM_POWERS][BLOCK];
+    };
+
+    // key_bytes is 16 or 32
+    static Key expand(const uint8_t* key, size_t key_bytes);
+    static GcmKey gcmExpand(const uint8_t* key, size_t key_bytes);
+
+    static void ecb(const Key& key, Direction direction, const uint8_t* in, uint8_t* out, size_t blocks);
+
+    // Single blocks under one key, its round keys loaded into registers once for all of them, so a
+    // block costs its rounds rather than a call and a schedule reload. Chain: out[i] is the cipher
+    // of out[i - 1], from in[0], one block in the AES unit at a time (its latency); in may be out.
+    // Independent: out[i] is the cipher of in[i], as ECB, eight in flight (its throughput).
+    enum class BlockMode { Chain, Independent };
+    static void blocks(const Key& key, Direction direction, BlockMode mode, const uint8_t* in, uint8_t* out, size_t count);
+    // counter is the big-endian counter block of the first block, left one past the last
+    static void ctr(Engine engine, const Key& key, uint8_t* counter, const uint8_t* in, uint8_t* out, size_t blocks);
+    // One data unit: its first tweak is the little-endian unit number encrypted with tweak_key
+    static void xts(Engine engine, const Key& data_key, const Key& tweak_key, Direction direction, uint64_t unit, const uint8_t* in,
+                    uint8_t* out, size_t blocks);
+
+    // Authenticated encryption of bytes of any length under a 96-bit IV, the 16-byte tag over aad
+    // and the ciphertext. gcmDecrypt returns false when the tag does not match; out is written anyway.
+    static void gcmEncrypt(GcmEngine engine, const GcmKey& key, const uint8_t* iv, const uint8_t* aad, size_t aad_bytes,
+                           const uint8_t* in, uint8_t* out, size_t bytes, uint8_t* tag);
+    static bool gcmDecrypt(GcmEngine engine, const GcmKey& key, const uint8_t* iv, const uint8_t* aad, size_t aad_bytes,
+                           const uint8_t* in, uint8_t* out, size_t bytes, const uint8_t* tag);
+
+    static size_t inFlight(Engine engine);    // blocks per group of the CTR and XTS pipelines
+    static size_t inFlight(GcmEngine engine); // blocks per group, and per GHASH reduction, of AES-GCM
+
+    // False with the reason in failure when any known answer is wrong.
+    static bool selfTest(std::string& failure);
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class RunControl;
+class ProgressCounter;
+
+// Exact 3n+1 step counts (n even: n/2, n odd: 3n+1, until 1), one starting value per vector lane:
+// 8 per AVX2 group, 16 per AVX-512 group, following the vector variant CpuDispatch picked, with
+// a scalar reference that every path must agree with.
+class Collatz {
+public:
+    static uint64_t steps(uint64_t n);
+    // steps[i] = steps(starts[i]) for any count; the tail that does not fill a group runs scalar.
+    static void batch(const uint64_t* starts, uint64_t* steps, size_t count);
+    static const char* name();
+};
+
+// Exact maximum step count over [lower, upper] and its smallest witness, computed by a team of
+// threads. Every n in the range is 2^a * m with m odd, and in that family the largest a wins, so
+// only odd m are started and each scores steps(m) + a. An odd m = 3k+2 is skipped when
+// (2m-1)/3, which reaches m in two steps, is itself a start: it always outscores m.
+// Trajectories jump 16 steps at a time through a residue table and finish in a table of step
+// counts for small values; together about 1.5MB, sized for L2. Values that would overflow 64 bits
+// finish on 128-bit arithmetic.
+// The starts are split into chunks; each thread works through its own contiguous share and, once
+// that runs out, steals the back half of the largest remaining share.
+class CollatzSweep {
+public:
+    struct Best {
+        uint64_t steps = 0;
+        uint64_t witness = 0; // smallest n in the range with that many steps
+    };
+
+    CollatzSweep(uint64_t lower, uint64_t upper, unsigned threads);
+
+    // One thread's part of the sweep until no chunk is left or run stops. The last thread to run
+    // out of work stops the run, so the window ends with the sweep. progress counts started values.
+    void work(unsigned thread, RunControl& run, ProgressCounter& progress);
+
+    bool complete() const { return chunks_done_.load() == chunk_count_; }
+    Best best() const;
+    uint64_t starts() const;  // trajectories computed
+    uint64_t skipped() const; // odd 3k+2 values skipped
+    uint64_t values() const { return upper_ - lower_ + 1; }
+
+    // Plain step count on 128-bit values, the reference the result is checked against.
+    static uint64_t referenceSteps(uint64_t n);
+
+private:
+    struct Interval {
+        uint64_t first;  // first odd value
+        uint64_t count;  // odd values in it
+        uint64_t before; // odd values in the intervals before it
+    };
+    struct alignas(64) Share {
+        std::atomic<uint64_t> span{0}; // chunk indices [low word, high word)
+        Best best;
+        uint64_t starts = 0;
+        uint64_t skipped = 0;
+    };
+
+    bool isStart(uint64_t m) const;
+    unsigned doublings(uint64_t m) const; // largest a with m * 2^a <= upper
+    void sweepChunk(uint64_t chunk, Share& share) const;
+    bool steal(unsigned thief);
+
+    uint64_t lower_, upper_;
+    std::vector<Interval> intervals_; // the odd m whose family meets [lower, upper]
+    uint64_t total_ = 0;              // odd values over all intervals
+    uint64_t chunk_size_ = 0;
+    uint64_t chunk_count_ = 0;
+    std::vector<Share> shares_;
+    std::atomic<uint64_t> chunks_done_{0};
+    std::atomic<unsigned> working_;
+};
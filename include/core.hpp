@@ -1,22 +1,31 @@
 #pragma once
 #include <cstddef>
 extern "C" {
-    void sha256(long iterations);
+    long sha256(long iterations, const volatile unsigned * stop = nullptr, unsigned * digest = nullptr);
+    long check_sha_support();
     void initGPU(int iterations);
     void p3np1E(unsigned long a, unsigned long * steps);
+    void p3np1Avx2(const unsigned long * starts, unsigned long * steps, unsigned long count);
+    void p3np1Avx512(const unsigned long * starts, unsigned long * steps, unsigned long count);
     void primes(unsigned long a, unsigned long * steps);
     void avx(float * a, float * b, float * c);
-    void floodL1L2(void* buffer, unsigned long * iterations_ptr, size_t buffer1_size);
-    void floodMemory(void* buffer, unsigned long * iterations_ptr, size_t buffer_size);
-    void rowhammerAttack(void* buffer, unsigned long * iterations_ptr, size_t buffer_size);
-    void floodNt(void * buffer, unsigned long * iterations_ptr, size_t buffer_size);
+    void avxSse(float * a, float * b, float * c);
+    void avx512(float * a, float * b, float * c);
+    void avxThroughputSse(float * a, float * b, float * c);
+    void avxThroughput(float * a, float * b, float * c);
+    void avx512Throughput(float * a, float * b, float * c);
+    unsigned long floodL1L2(void* buffer, unsigned long * iterations_ptr, size_t buffer1_size, const volatile unsigned * stop = nullptr);
+    unsigned long floodMemory(void* buffer, unsigned long * iterations_ptr, size_t buffer_size, const volatile unsigned * stop = nullptr);
+    unsigned long rowhammerAttack(void* buffer, unsigned long * iterations_ptr, size_t buffer_size, const volatile unsigned * stop = nullptr);
+    unsigned long floodNt(void * buffer, unsigned long * iterations_ptr, size_t buffer_size, const volatile unsigned * stop = nullptr);
     void aes128EncryptBlock(void * out, const void * in, const void * key);
-    void aes256Keygen(void* expanded_key);
+    void aes256Keygen(void* expanded_key, const void * key);
     void aesXtsEncrypt(void * out, const void * in, const void* key, const void * tweak, size_t blocks);
     void aes128DecryptBlock(void * out, const void * in, const void * key);
     void aesXtsDecrypt(void * out, const void * in, const void* key, const void * tweak, size_t blocks);
-    void diskWrite(const char * name);
+    size_t diskWrite(const char * name, const volatile unsigned * stop = nullptr);
     void startLZMA(int duration);
+    double startLZMAPartition(int duration, unsigned threads, unsigned first_core);
     void spawn_system_monitor();
     void stop_system_monitor();
 }
\ No newline at end of file
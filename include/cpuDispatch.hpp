@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+
+// CPU features from CPUID and XGETBV, and the kernel variants picked from them once at startup,
+// so one binary runs the widest code each host supports instead of dying with SIGILL.
+// ESST_ISA=sse42|avx2|avx512 caps the vector variants, ESST_SHA=shani|avx512|avx2|software
+// picks the SHA-256 engine, ESST_AES=aesni|vaes256|vaes512 the AES one and
+// ESST_GCM=pclmul|vpclmul256|vpclmul512 the AES-GCM one, e.g. to compare variants on one
+// machine. ESST_FMA_PORTS (default 2) sets the FP ports per core behind the peak FLOP/cycle.
+class CpuDispatch {
+public:
+    enum class Vector { None, Sse42, Avx2, Avx512 };
+    // AES engines: xmm AES-NI, or VAES with two or four blocks per ymm/zmm instruction
+    enum class Aes { None, AesNiVex, Vaes256, Vaes512 };
+    // AES-GCM engines: the AES engine of the same width with GHASH on PCLMULQDQ or VPCLMULQDQ
+    enum class Gcm { None, Pclmul, Vpclmul256, Vpclmul512 };
+    // SHA-256 engines: single-stream SHA extensions, or multi-buffer vector lanes
+    enum class Sha { Software, Avx2, Avx512, ShaNi };
+    // Latency: the waves of avx, each result feeding the next. Throughput: independent chains
+    // that keep every FP port busy, the maximum-power load.
+    enum class AvxMode { Latency, Throughput };
+
+    // Usable features: vector extensions count only if the OS saves their registers.
+    struct Features {
+        bool sse42 = false, avx = false, avx2 = false, fma = false, avx512f = false, avx512bw = false;
+        bool aes = false, vaes = false, pclmul = false, vpclmul = false, sha = false, bmi2 = false;
+    };
+
+    using AvxKernel = void (*)(float* a, float* b, float* c);
+
+    struct AvxVariant {
+        AvxKernel run = nullptr; // nullptr when no variant runs on this CPU
+        unsigned floats = 0;     // floats each call consumes from each input
+        double flops = 0;        // floating-point operations per call, an FMA counting two
+        double instructions = 0; // score credited per call
+    };
+
+    static const CpuDispatch& get();
+
+    const Features& features() const { return features_; }
+    Vector vector() const { return vector_; }
+    Aes aes() const { return aes_; }
+    Gcm gcm() const { return gcm_; }
+    Sha sha() const { return sha_; }
+    bool supports(Sha sha) const;
+    bool supports(Aes aes) const;
+    bool supports(Gcm gcm) const;
+
+    // Selected entry points
+    const AvxVariant& avx(const AvxMode mode) const { return mode == AvxMode::Throughput ? avx_throughput_ : avx_latency_; }
+    double peak_flops_per_cycle = 0; // of one core running the avx variant's vectors on every FP port
+
+    std::string featureSummary() const;
+    std::string kernelSummary() const;
+
+    static const char* name(Vector vector);
+    static const char* name(Aes aes);
+    static const char* name(Gcm gcm);
+    static const char* name(Sha sha);
+    static const char* name(AvxMode mode);
+    static const char* option(Sha sha); // its ESST_SHA value
+    static const char* option(Aes aes); // its ESST_AES value
+    static const char* option(Gcm gcm); // its ESST_GCM value
+
+private:
+    CpuDispatch();
+
+    Features features_;
+    AvxVariant avx_latency_, avx_throughput_;
+    Vector vector_ = Vector::None;
+    Aes aes_ = Aes::None;
+    Gcm gcm_ = Gcm::None;
+    Sha sha_ = Sha::Software;
+};
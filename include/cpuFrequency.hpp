@@ -0,0 +1,60 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Effective clock of the CPUs a run uses, averaged over its window, from the best source available:
+//  - APERF/MPERF deltas via /dev/cpu/N/msr (msr module loaded, root),
+//  - scaling_cur_freq sampled during the window,
+//  - a dependent-add busy loop timed with the calibrated TSC, run on each worker right after its
+//    kernel returns, while the core still carries the kernel's voltage/license state.
+class FrequencySampler {
+public:
+    enum class Source { AperfMperf, ScalingCurFreq, BusyLoop };
+
+    explicit FrequencySampler(std::vector<int> cpus);
+    ~FrequencySampler();
+    FrequencySampler(const FrequencySampler&) = delete;
+    FrequencySampler& operator=(const FrequencySampler&) = delete;
+
+    // Window boundaries, called by the controlling thread.
+    void start();
+    void stop();
+
+    // Called by worker index on its own (pinned) thread once its kernel is done; only the
+    // busy-loop source measures anything here.
+    void measureHere(size_t index);
+
+    // Average MHz of every CPU over the window, 0 where nothing could be measured.
+    std::vector<double> mhz() const;
+
+    Source source() const { return source_; }
+    static const char* name(Source source);
+
+    // TSC rate, calibrated once against steady_clock.
+    static double tscHz();
+
+    // Clock of the calling thread's core, from the busy loop.
+    static double busyLoopMHz();
+
+    // Instantaneous average over the allowed CPUs (scaling_cur_freq, else /proc/cpuinfo), for the monitor.
+    static double currentMHz();
+
+private:
+    static Source detect();
+
+    const std::vector<int> cpus_;
+    const Source source_;
+    std::vector<int> msr_fds_;
+    std::vector<uint64_t> aperf_, mperf_;
+    std::vector<double> sum_mhz_;
+    std::vector<unsigned> samples_;
+    std::vector<double> result_;
+
+    std::thread poller_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 64-bit FNV-1a over everything a kernel round produced.
+class Digest {
+public:
+    void add(const void* data, size_t size);
+    void add(uint64_t value) { add(&value, sizeof(value)); }
+    uint64_t value() const { return state_; }
+
+private:
+    uint64_t state_ = 0xcbf29ce484222325ull;
+};
+
+// Silent-data-corruption check for one kernel run. In checked mode every worker cycles through
+// the same ROUNDS seeded rounds, so every core must produce the same digest for a given round.
+// The reference digests are computed first on a single core with the rest of the machine idle;
+// each worker verifies every round it completes against them, and the report also compares the
+// cores with each other, which tells a bad core apart from a bad reference.
+class IntegrityCheck {
+public:
+    static constexpr unsigned ROUNDS = 16;
+    static constexpr size_t MAX_LOGGED = 8; // mismatches kept per thread, the rest are only counted
+
+    struct Mismatch {
+        uint64_t iteration; // the thread's own round counter, from 0
+        unsigned round;
+        uint64_t expected, actual;
+    };
+
+    IntegrityCheck(std::string kernel, unsigned threads, int reference_cpu);
+
+    void setReference(unsigned round, uint64_t digest) { reference_[round] = digest; }
+
+    // Worker side; each thread only touches its own log. Returns whether the digest matched.
+    bool verify(unsigned thread, uint64_t iteration, uint64_t digest);
+
+    uint64_t mismatches() const;
+
+    // Per-thread verdicts, the logged mismatches and the cross-core comparison; cpus maps
+    // threads to CPUs. Returns whether the run was clean.
+    bool report(std::ostream& out, const std::vector<int>& cpus) const;
+
+    const std::string& kernel() const { return kernel_; }
+
+private:
+    struct alignas(64) ThreadLog {
+        std::array<uint64_t, ROUNDS> first{}; // first digest seen for each round
+        std::array<bool, ROUNDS> seen{};
+        uint64_t checked = 0, failed = 0;
+        std::vector<Mismatch> logged;
+    };
+
+    std::string kernel_;
+    int reference_cpu_;
+    std::array<uint64_t, ROUNDS> reference_{};
+    std::vector<ThreadLog> threads_;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Deterministic primality of any 64-bit n: strong probable-prime tests to the seven bases of
+// Sinclair's set, in Montgomery form so every modular product is a multiply and a reduction
+// instead of a div. batch() runs CHAINS candidates in lockstep as independent dependency chains,
+// keeping the 64x64->128 multiplier busy while each chain waits on its previous product; with
+// BMI2 the products compile to mulx.
+class MillerRabin {
+public:
+    static constexpr size_t CHAINS = 4;
+
+    static bool isPrime(uint64_t n);
+    // prime[i] = isPrime(n[i]) for any count.
+    static void batch(const uint64_t* n, uint8_t* prime, size_t count);
+    static const char* name();
+};
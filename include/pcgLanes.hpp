@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Sixteen pcg32 (XSH-RR) generators stepped together in vector registers, for filling input
+// buffers in bulk instead of one scalar draw per value. Lane i is exactly pcg32(seed, stream * 16 + i),
+// and the output interleaves the lanes. The AVX-512F, AVX2 or scalar stepper follows the vector
+// variant CpuDispatch picked; all three produce the same sequence.
+class PcgLanes {
+public:
+    static constexpr size_t LANES = 16;
+
+    PcgLanes(uint64_t seed, uint64_t stream);
+
+    void fill(uint32_t* out, size_t count);
+    void fillBytes(uint8_t* out, size_t count);
+    // Uniform in [lower, upper), as std::uniform_real_distribution.
+    void fillUniform(float* out, size_t count, float lower, float upper);
+    // Uniform in [lower, upper], as std::uniform_int_distribution.
+    void fillUniform(uint64_t* out, size_t count, uint64_t lower, uint64_t upper);
+
+private:
+    using Stepper = void (*)(uint64_t* state, const uint64_t* inc, uint32_t* out, size_t blocks);
+    static Stepper stepper();
+
+    alignas(64) uint64_t state_[LANES];
+    alignas(64) uint64_t inc_[LANES];
+    Stepper step_;
+};
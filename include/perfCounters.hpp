@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <string>
+
+// Hardware counters of the calling thread via perf_event_open. User space only, so the usual
+// perf_event_paranoid=2 still allows them. Each event is opened on its own and scaled by
+// time_enabled/time_running, so a PMU with fewer counters than events multiplexes instead of
+// failing, and an event the CPU lacks only drops that one figure.
+class PerfCounters {
+public:
+    enum Event { Instructions, Cycles, L1dMisses, LlcMisses, BranchMisses, DtlbMisses, EVENT_COUNT };
+
+    struct Counts {
+        std::array<double, EVENT_COUNT> value{};
+        std::array<bool, EVENT_COUNT> valid{};
+
+        bool has(const Event event) const { return valid[event]; }
+        double ipc() const;              // 0 if instructions or cycles are missing
+        double mpki(Event event) const;  // misses per 1000 instructions, 0 if missing
+    };
+
+    // Opens the counters for the calling thread, disabled; opens nothing if !available().
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void start();
+    Counts stop();
+
+    // Probed once: whether the instruction counter can be opened, and why not.
+    static bool available();
+    static const std::string& unavailableReason();
+
+    static const char* name(Event event);
+
+private:
+    std::array<int, EVENT_COUNT> fds_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class RunControl;
+class ProgressCounter;
+
+// Exact prime count π(limit) by a segmented Sieve of Eratosthenes on a mod-30 wheel: each byte
+// holds the eight residues coprime to 30, so a segment of half the L2 covers 15x its size in
+// numbers and the multiples of 2, 3 and 5 are never touched. Threads claim segments one at a
+// time from a shared counter and cross off the sieving primes up to sqrt(limit) in each.
+class PrimeSieve {
+public:
+    static constexpr uint64_t MAX_LIMIT = 100'000'000'000'000; // 1e14, sieving primes below 1e7
+
+    PrimeSieve(uint64_t limit, unsigned threads);
+
+    // One thread's part of the sieve until no segment is left or run stops. The last thread to run
+    // out of segments stops the run, so the window ends with the sieve. progress counts primes.
+    void work(unsigned thread, RunControl& run, ProgressCounter& progress);
+
+    bool complete() const { return segments_done_.load() == segment_count_; }
+    uint64_t count() const; // primes <= limit found so far; π(limit) once complete
+    uint64_t limit() const { return limit_; }
+    uint64_t segments() const { return segment_count_; }
+    size_t segmentBytes() const { return segment_bytes_; }
+
+    // prime[i] = whether lower + i is prime, for lower + count - 1 <= limit: the plain sieve of the
+    // range by 2, 3, 5 and the sieving primes, an independent reference for other primality tests.
+    void primality(uint64_t lower, size_t count, uint8_t* prime) const;
+
+    // Tabulated π(10^k) and π(2^32), the known values the count is checked against.
+    static std::optional<uint64_t> knownCount(uint64_t x);
+
+private:
+    struct alignas(64) Share {
+        uint64_t primes = 0;
+    };
+
+    void sieveSegment(uint64_t segment, std::vector<uint8_t>& bits) const;
+
+    uint64_t limit_;
+    size_t segment_bytes_;
+    uint64_t segment_count_;
+    std::vector<uint32_t> sieving_; // primes from 7 to sqrt(limit)
+    std::vector<Share> shares_;
+    std::atomic<uint64_t> next_segment_{0};
+    std::atomic<uint64_t> segments_done_{0};
+    std::atomic<unsigned> working_;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Work counter of one thread, alone on its cache line so publishing never contends with
+// another thread. Only the owning thread writes; the sampler reads it concurrently.
+class alignas(64) ProgressCounter {
+public:
+    void add(const double units) { units_.store(units_.load(std::memory_order_relaxed) + units, std::memory_order_relaxed); }
+    double units() const { return units_.load(std::memory_order_relaxed); }
+
+private:
+    static_assert(std::atomic<double>::is_always_lock_free, "workers publish progress without locking");
+    std::atomic<double> units_{0};
+};
+
+// Reads a set of ProgressCounters at a fixed interval and keeps the cumulative units of every
+// thread per sample. While running it redraws a live per-thread throughput block when stdout
+// is a terminal; afterwards the final rates and the timeline report come from the same samples.
+class ProgressSampler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Formatter = std::function<std::string(double)>;
+
+    struct Sample {
+        double time;               // seconds since the start of the window
+        std::vector<double> units; // cumulative units per thread
+    };
+
+    ProgressSampler(const std::vector<ProgressCounter>& counters, std::vector<std::string> labels, Formatter format,
+                    std::chrono::milliseconds interval = std::chrono::seconds(1));
+    ~ProgressSampler();
+    ProgressSampler(const ProgressSampler&) = delete;
+    ProgressSampler& operator=(const ProgressSampler&) = delete;
+
+    // Starts sampling at origin + k * interval.
+    void start(Clock::time_point origin);
+
+    // Stops the sampler and records the final sample at window seconds, once every worker is done.
+    void stop(double window);
+
+    const std::vector<Sample>& timeline() const { return timeline_; }
+
+    // Units per second of every thread over the whole window.
+    std::vector<double> rates() const;
+
+    // Aggregate throughput per interval plus each thread's slowest interval and drift between halves.
+    void report(std::ostream& out) const;
+
+private:
+    void sample(double time);
+    void draw();
+    double intervalRate(size_t sample, size_t thread) const;
+
+    const std::vector<ProgressCounter>& counters_;
+    const std::vector<std::string> labels_;
+    const Formatter format_;
+    const Clock::duration interval_;
+    const bool live_;
+
+    std::vector<Sample> timeline_;
+    unsigned drawn_lines_ = 0;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
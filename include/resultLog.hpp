@@ -0,0 +1,80 @@
+#pragma once
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Structured results of every command run, so fleet scripts don't have to scrape the console.
+// Each run is written as <dir>/esst-<timestamp>-<command>.json and .csv, where dir is
+// $ESST_RESULTS_DIR or ./esst-results. With a baseline loaded (the CSV of an earlier run on the
+// same hardware), each kernel's total throughput is checked against it and the gate fails when
+// it falls outside the tolerance. Runs failed by other checks carry their reasons.
+class ResultLog {
+public:
+    struct Record {
+        std::string kernel;
+        int thread;        // -1 = aggregate over all threads
+        int cpu;           // -1 = not tied to one CPU
+        double throughput; // per second, in unit
+        std::string unit;
+        double duration;   // seconds
+        double mhz = 0;    // average effective clock of the thread's core, 0 if unknown
+        double instructions = 0; // measured instructions per second, 0 without hardware counters
+        double ipc = 0;
+    };
+
+    static ResultLog& shared();
+
+    void setMachine(std::string cpu_model, std::string version);
+
+    // Starts collecting for one command and samples temperatures until endRun().
+    void beginRun(const std::string& command);
+
+    // Thread-safe; records outside a run are dropped.
+    void record(Record record);
+
+    // Writes the run's files and applies the baseline gate. Returns false if the gate failed.
+    bool endRun();
+
+    // Loads a CSV written by an earlier run; tolerance is a fraction (0.05 = +/-5%).
+    bool loadBaseline(const std::string& path, double tolerance);
+
+    // Fails the current run for a reason outside the baseline gate (e.g. silent data corruption);
+    // the reasons are exported with the run.
+    void fail(std::string reason);
+
+    // Whether any run of this session failed the baseline gate or a check.
+    bool failed() const { return failed_; }
+
+private:
+    struct Temperatures {
+        std::optional<float> cpu_start, cpu_end, cpu_max, gpu_max;
+    };
+    struct Baseline {
+        std::string path;
+        std::string cpu_model;
+        std::map<std::string, std::vector<Record>> runs; // by command
+        double tolerance = 0;
+    };
+
+    void sampleTemperatures();
+    bool compare() const;
+    void write() const;
+
+    std::string cpu_model_, version_;
+    std::string command_, timestamp_;
+    std::vector<Record> records_;
+    std::vector<std::string> failures_;
+    Temperatures temps_;
+    std::optional<Baseline> baseline_;
+    bool active_ = false;
+    bool failed_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread sampler_;
+    bool stopping_ = false;
+};
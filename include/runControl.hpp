@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <latch>
+#include <mutex>
+
+// Deadline and cooperative stop flag shared by every thread of a time-boxed run.
+// Kernels poll stopped() (or hand flag() to the asm entry points) between bounded chunks
+// of work; the controlling thread raises the flag at the deadline.
+// The window opens behind a start barrier: each of the participants calls arriveAndWait(),
+// and start() waits for all of them before starting the clock and releasing them together.
+// Finite jobs end the window early by calling requestStop() themselves once all work is done.
+class RunControl {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RunControl(const std::chrono::duration<double> duration, const unsigned participants = 0)
+        : duration_(std::chrono::duration_cast<Clock::duration>(duration)),
+          ready_(participants) {}
+
+    // Worker side of the start barrier.
+    void arriveAndWait() {
+        ready_.count_down();
+        go_.wait();
+    }
+
+    // Controller side: waits for every participant, opens the window and releases them.
+    void start() {
+        if (started_) return;
+        ready_.wait();
+        start_ = Clock::now();
+        deadline_ = start_ + duration_;
+        stopped_at_.store(deadline_.time_since_epoch().count(), std::memory_order_relaxed);
+        started_ = true;
+        go_.count_down();
+    }
+
+    Clock::time_point startTime() const { return start_; }
+
+    bool stopped() const { return stop_.load(std::memory_order_relaxed) != 0; }
+
+    // Raw view of the flag for the asm kernels, which poll it as a 32-bit word.
+    const volatile unsigned* flag() const { return reinterpret_cast<const volatile unsigned*>(&stop_); }
+
+    // Blocks the controlling thread until the deadline or an earlier requestStop(), then tells every kernel to stop.
+    void waitAndStop() {
+        start();
+        std::unique_lock lock(mutex_);
+        wake_.wait_until(lock, deadline_, [this] { return stopped(); });
+        lock.unlock();
+        requestStop();
+    }
+
+    // The first request closes the window; later ones are no-ops.
+    void requestStop() {
+        {
+            std::lock_guard lock(mutex_);
+            if (stopped()) return;
+            stopped_at_.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+            stop_.store(1, std::memory_order_release);
+        }
+        wake_.notify_all();
+    }
+
+    // Called by each thread when its kernel returns, to track how far past the deadline it ran.
+    void finished() {
+        const int64_t late = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - stoppedAt()).count();
+        int64_t seen = max_overrun_us_.load(std::memory_order_relaxed);
+        while (late > seen && !max_overrun_us_.compare_exchange_weak(seen, late, std::memory_order_relaxed)) {}
+    }
+
+    // The common measurement window, start of the run until the stop request, in seconds.
+    double window() const { return std::chrono::duration<double>(stoppedAt() - start_).count(); }
+
+    // Slowest thread's reaction to the stop request, in milliseconds.
+    double overrunMs() const { return std::max<int64_t>(0, max_overrun_us_.load()) / 1000.0; }
+
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "asm kernels read the stop flag as a plain word");
+
+    Clock::time_point stoppedAt() const { return Clock::time_point(Clock::duration(stopped_at_.load(std::memory_order_relaxed))); }
+
+    std::atomic<uint32_t> stop_{0};
+    std::atomic<int64_t> max_overrun_us_{0};
+    const Clock::duration duration_;
+    std::latch ready_;
+    std::latch go_{1};
+    bool started_ = false; // controller only
+    Clock::time_point start_;
+    Clock::time_point deadline_;
+    std::atomic<Clock::rep> stopped_at_{0};
+    std::mutex mutex_;
+    std::condition_variable wake_;
+};
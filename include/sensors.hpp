@@ -0,0 +1,18 @@
+#pragma once
+#include <optional>
+#include <string>
+
+// hwmon temperature sensors, shared by the GUI monitor and the result export.
+class Sensors {
+public:
+    // Package temperature of the CPU (coretemp / k10temp / zenpower), nullopt without a sensor.
+    static std::optional<float> cpuTemp();
+
+    // Edge temperature of the GPU (amdgpu), nullopt without a sensor.
+    static std::optional<float> gpuTemp();
+
+    // temp1_input of the first hwmon device whose name contains pattern, empty if none.
+    static std::string findSensor(const std::string& pattern);
+
+    static std::optional<float> readTemp(const std::string& path);
+};
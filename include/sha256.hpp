@@ -0,0 +1,28 @@
+#pragma once
+#include "cpuDispatch.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// SHA-256 (FIPS 180-4) of caller buffers. SHA-NI hashes one stream at a time; the AVX2 and
+// AVX-512 engines hash 8 or 16 streams of equal length side by side, one stream per vector lane,
+// message schedule included; the portable engine runs anywhere. All of them produce the same
+// digests, and selfTest() checks an engine against the FIPS 180-2 example vectors and against
+// the portable engine on streams of every padding case.
+class Sha256 {
+public:
+    using Engine = CpuDispatch::Sha;
+    using Digest = std::array<uint8_t, 32>;
+    static constexpr size_t BLOCK = 64;
+
+    // One buffer, on SHA-NI when the CPU has it.
+    static Digest hash(const void* data, size_t size);
+    // digests[i] = SHA-256 of the size bytes at data[i], for any count; multi-buffer engines take
+    // the streams in groups of lanes(engine).
+    static void hash(Engine engine, const uint8_t* const* data, size_t size, Digest* digests, size_t count);
+
+    static size_t lanes(Engine engine);
+    // False with the reason in failure when any digest of the engine is wrong.
+    static bool selfTest(Engine engine, std::string& failure);
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Distribution statistics for per-thread scores and for repeated runs of the same test.
+class Statistics {
+public:
+    struct Summary {
+        size_t count = 0;
+        double total = 0, mean = 0;
+        double stddev = 0; // sample standard deviation
+        double cv = 0;     // coefficient of variation, stddev / mean
+        double min = 0, max = 0;
+        double p5 = 0, p50 = 0, p95 = 0;
+    };
+
+    // A value that sits away from its peers by both a robust z-score and a relative margin.
+    struct Outlier {
+        size_t index;
+        double value;
+        double deviation; // relative to the median, -0.08 = 8% below
+        double z;         // modified z-score, 0.6745 * (value - median) / MAD
+    };
+
+    // Two-sided 95% confidence interval of a mean, from Student's t.
+    struct Interval {
+        size_t count;
+        double mean;
+        double half_width;
+    };
+
+    static Summary summarize(std::span<const double> values);
+
+    // Linear interpolation between closest ranks; p in [0, 1].
+    static double percentile(std::span<const double> sorted, double p);
+
+    // Median/MAD based, so one bad core cannot hide itself by inflating the spread. A value is
+    // flagged once it is at least min_deviation away from the median and its modified z-score
+    // exceeds z_limit (or the peers are identical). Needs at least three values.
+    static std::vector<Outlier> outliers(std::span<const double> values, double min_deviation = 0.05, double z_limit = 3.5);
+
+    static std::optional<Interval> confidence95(std::span<const double> runs);
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Layout of the CPUs this process is allowed to run on, read from /sys/devices/system/cpu,
+// /sys/devices/system/node and sched_getaffinity, so cpuset/cgroup limits are honoured.
+// detect() must run on a thread that still carries the process affinity mask (i.e. before
+// it gets pinned), since that mask defines the allowed set.
+class Topology {
+public:
+    struct Cpu {
+        int id;      // logical CPU number
+        int package; // physical_package_id
+        int core;    // core_id, unique within its package
+        int smt;     // position among the core's SMT siblings, 0 = first thread
+        int l3;      // lowest CPU sharing this CPU's L3, identifies the L3/CCX domain
+        int node;    // NUMA node
+    };
+
+    enum class Placement {
+        PhysicalCores, // one thread per physical core
+        FillSmt,       // every allowed CPU, SMT siblings next to each other
+        SpreadL3,      // round-robin over L3 domains, first threads of every core before siblings
+        PackNode,      // every allowed CPU of a single NUMA node
+    };
+
+    static Topology detect();
+
+    // Ordered list of CPUs for the policy; worker i of a pool built from it runs on entry i.
+    // node selects the NUMA node for PackNode (-1 = node of the first allowed CPU).
+    std::vector<int> place(Placement policy, int node = -1) const;
+
+    const std::vector<Cpu>& cpus() const { return cpus_; }
+    int nodeOf(int cpu) const;
+    std::vector<int> nodes() const;
+    std::string summary() const;
+
+    // Binds [addr, addr + size) to node before it is first touched. Returns false when the kernel
+    // has no NUMA support or rejects the policy; the range then falls back to first-touch.
+    static bool bindMemory(void* addr, size_t size, int node);
+
+    // Node backing the (already faulted-in) page at addr, -1 if unknown.
+    static int memoryNode(const void* addr);
+
+    static std::optional<Placement> parsePlacement(std::string_view name);
+    static const char* name(Placement policy);
+
+private:
+    std::vector<Cpu> cpus_; // allowed CPUs, ascending id
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of pre-pinned worker threads shared by every stress command.
+// Worker i is pinned to cpu(i) once, at startup, and never migrates. Each worker owns a
+// task deque: the owner pops from the back, idle workers steal from the front of a deque
+// whose owner is busy, so placement is kept whenever the target worker is free.
+class WorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    // Completion tracker for a batch of tasks submitted together.
+    class Group {
+    public:
+        void wait();
+
+    private:
+        friend class WorkerPool;
+        void finish();
+
+        size_t pending = 0;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    explicit WorkerPool(std::vector<int> cpus);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+    int cpu(const unsigned worker) const { return workers_[worker % size()]->cpu; }
+
+    // Queues task on worker (worker % size()); completion is reported to group.
+    void submit(Group& group, unsigned worker, Task task);
+
+    // Runs fn(i) for i in [0, count), task i queued on worker first_worker + i, and waits.
+    void parallel(unsigned count, const std::function<void(unsigned)>& fn, unsigned first_worker = 0);
+
+    // Joins every worker and respawns the pool pinned to cpus. Only call while no group is pending.
+    void reset(std::vector<int> cpus);
+
+    // Process-wide pool with one worker per allowed CPU (siblings adjacent), created on first use.
+    static WorkerPool& shared();
+
+    static void pinThread(int cpu);
+
+private:
+    struct Worker {
+        int cpu;
+        bool busy = false;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void spawn(std::vector<int> cpus);
+    void shutdown();
+    void loop(unsigned self);
+    int findVictim(unsigned self) const;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cmath>
 #include <thread>
+#include "resultLog.hpp"
 
 // Data structure for storing benchmark results
 struct BenchmarkResult {
@@ -465,6 +466,7 @@ public:
                       << std::setw(8) << r.score
                       << std::setw(10) << std::setprecision(1) << r.reference
                       << "\n";
+            ResultLog::shared().record({"gpu-" + r.test_name, -1, -1, r.operations_per_second, "ops/s", r.execution_time_ms / 1000.0});
         }
         std::cout << "\n";
     }
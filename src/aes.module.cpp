@@ -0,0 +1,1070 @@
+#include "aes.hpp"
+#include "core.hpp"
+#include <immintrin.h>
+#include <cstring>
+#include <vector>
+
+#define AES_TARGET __attribute__((target("aes,avx")))
+
+namespace {
+
+constexpr size_t IN_FLIGHT = 8; // blocks per group, enough to cover vaesenc latency over its throughput
+
+AES_TARGET inline __m128i load(const uint8_t* bytes) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)); }
+AES_TARGET inline void store(uint8_t* bytes, const __m128i value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), value); }
+
+// w0, w0^w1, w0^w1^w2, w0^w1^w2^w3: the chain of XORs through the previous round key
+AES_TARGET inline __m128i prefixXor(__m128i key) {
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, _mm_slli_si128(key, 4));
+}
+
+// RotWord(SubWord(w3)) xor Rcon in every word; aeskeygenassist takes Rcon as an immediate
+template <int Rcon> AES_TARGET inline __m128i rotSub(const __m128i key) {
+    return _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, Rcon), 0xff);
+}
+
+// SubWord(w3) in every word, the extra step of AES-256
+AES_TARGET inline __m128i sub(const __m128i key) { return _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, 0), 0xaa); }
+
+template <int Rcon> AES_TARGET inline __m128i next128(const __m128i key) { return _mm_xor_si128(prefixXor(key), rotSub<Rcon>(key)); }
+
+AES_TARGET void expand128(__m128i* k) {
+    k[1] = next128<0x01>(k[0]);
+    k[2] = next128<0x02>(k[1]);
+    k[3] = next128<0x04>(k[2]);
+    k[4] = next128<0x08>(k[3]);
+    k[5] = next128<0x10>(k[4]);
+    k[6] = next128<0x20>(k[5]);
+    k[7] = next128<0x40>(k[6]);
+    k[8] = next128<0x80>(k[7]);
+    k[9] = next128<0x1b>(k[8]);
+    k[10] = next128<0x36>(k[9]);
+}
+
+// Round keys alternate between the two halves of the key: an even one takes RotWord, SubWord
+// and Rcon of the odd one before it, an odd one only SubWord of the even one before it
+template <int Rcon> AES_TARGET inline void next256(__m128i* k) {
+    k[2] = _mm_xor_si128(prefixXor(k[0]), rotSub<Rcon>(k[1]));
+    if constexpr (Rcon != 0x40) k[3] = _mm_xor_si128(prefixXor(k[1]), sub(k[2]));
+}
+
+AES_TARGET void expand256(__m128i* k) {
+    next256<0x01>(k);
+    next256<0x02>(k + 2);
+    next256<0x04>(k + 4);
+    next256<0x08>(k + 6);
+    next256<0x10>(k + 8);
+    next256<0x20>(k + 10);
+    next256<0x40>(k + 12);
+}
+
+AES_TARGET void expandKey(const uint8_t* key, const size_t key_bytes, Aes::Key& out) {
+    __m128i k[Aes::MAX_ROUNDS + 1];
+    k[0] = load(key);
+    if (key_bytes == 32) {
+        k[1] = load(key + 16);
+        expand256(k);
+        out.rounds = 14;
+    } else {
+        expand128(k);
+        out.rounds = 10;
+    }
+    for (unsigned r = 0; r <= out.rounds; ++r) {
+        store(out.encrypt[r], k[r]);
+        store(out.decrypt[r], r == 0 || r == out.rounds ? k[r] : _mm_aesimc_si128(k[r]));
+    }
+}
+
+// The rounds of N blocks, round key outermost so the N vaesenc of a round are independent.
+// keys points at a schedule of Aes::Key, 16-byte aligned.
+template <size_t N> AES_TARGET inline void encryptBlocks(__m128i* blocks, const __m128i* keys, const unsigned rounds) {
+#pragma GCC unroll 8
+    for (size_t j = 0; j < N; ++j) blocks[j] = _mm_xor_si128(blocks[j], keys[0]);
+    for (unsigned r = 1; r < rounds; ++r) {
+        const __m128i key = keys[r];
+#pragma GCC unroll 8
+        for (size_t j = 0; j < N; ++j) blocks[j] = _mm_aesenc_si128(blocks[j], key);
+    }
+#pragma GCC unroll 8
+    for (size_t j = 0; j < N; ++j) blocks[j] = _mm_aesenclast_si128(blocks[j], keys[rounds]);
+}
+
+template <size_t N> AES_TARGET inline void decryptBlocks(__m128i* blocks, const __m128i* keys, const unsigned rounds) {
+#pragma GCC unroll 8
+    for (size_t j = 0; j < N; ++j) blocks[j] = _mm_xor_si128(blocks[j], keys[rounds]);
+    for (unsigned r = rounds - 1; r > 0; --r) {
+        const __m128i key = keys[r];
+#pragma GCC unroll 8
+        for (size_t j = 0; j < N; ++j) blocks[j] = _mm_aesdec_si128(blocks[j], key);
+    }
+#pragma GCC unroll 8
+    for (size_t j = 0; j < N; ++j) blocks[j] = _mm_aesdeclast_si128(blocks[j], keys[0]);
+}
+
+template <size_t N>
+AES_TARGET inline void cipherBlocks(__m128i* blocks, const Aes::Key& key, const Aes::Direction direction) {
+    if (direction == Aes::Direction::Encrypt) encryptBlocks<N>(blocks, reinterpret_cast<const __m128i*>(key.encrypt), key.rounds);
+    else decryptBlocks<N>(blocks, reinterpret_cast<const __m128i*>(key.decrypt), key.rounds);
+}
+
+// Single blocks with the schedule copied into locals once per call: with Rounds a constant the
+// round loops unroll, and the round keys stay in registers across all the blocks instead of
+// coming back from memory for each (all of them for a chain; for ECB, what eight blocks in flight
+// leave of the sixteen xmm registers)
+template <unsigned Rounds>
+AES_TARGET void ecbRounds(const Aes::Key& key, const Aes::Direction direction, const uint8_t* in, uint8_t* out, size_t blocks) {
+    __m128i keys[Rounds + 1];
+    for (unsigned r = 0; r <= Rounds; ++r) keys[r] = load(direction == Aes::Direction::Encrypt ? key.encrypt[r] : key.decrypt[r]);
+    for (; blocks >= IN_FLIGHT; blocks -= IN_FLIGHT, in += IN_FLIGHT * Aes::BLOCK, out += IN_FLIGHT * Aes::BLOCK) {
+        __m128i b[IN_FLIGHT];
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) b[j] = load(in + j * Aes::BLOCK);
+        if (direction == Aes::Direction::Encrypt) encryptBlocks<IN_FLIGHT>(b, keys, Rounds);
+        else decryptBlocks<IN_FLIGHT>(b, keys, Rounds);
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) store(out + j * Aes::BLOCK, b[j]);
+    }
+    for (; blocks > 0; --blocks, in += Aes::BLOCK, out += Aes::BLOCK) {
+        __m128i b = load(in);
+        if (direction == Aes::Direction::Encrypt) encryptBlocks<1>(&b, keys, Rounds);
+        else decryptBlocks<1>(&b, keys, Rounds);
+        store(out, b);
+    }
+}
+
+// out[i] = cipher of out[i - 1], from in[0]: each block waits for the one before it
+template <unsigned Rounds>
+AES_TARGET void chainRounds(const Aes::Key& key, const Aes::Direction direction, const uint8_t* in, uint8_t* out, size_t blocks) {
+    __m128i keys[Rounds + 1];
+    for (unsigned r = 0; r <= Rounds; ++r) keys[r] = load(direction == Aes::Direction::Encrypt ? key.encrypt[r] : key.decrypt[r]);
+    __m128i b = load(in);
+    if (direction == Aes::Direction::Encrypt) {
+        for (; blocks > 0; --blocks, out += Aes::BLOCK) {
+            encryptBlocks<1>(&b, keys, Rounds);
+            store(out, b);
+        }
+    } else {
+        for (; blocks > 0; --blocks, out += Aes::BLOCK) {
+            decryptBlocks<1>(&b, keys, Rounds);
+            store(out, b);
+        }
+    }
+}
+
+AES_TARGET void ecbBlocks(const Aes::Key& key, const Aes::Direction direction, const uint8_t* in, uint8_t* out, const size_t blocks) {
+    if (key.rounds == 14) ecbRounds<14>(key, direction, in, out, blocks);
+    else ecbRounds<10>(key, direction, in, out, blocks);
+}
+
+AES_TARGET void chainBlocks(const Aes::Key& key, const Aes::Direction direction, const uint8_t* in, uint8_t* out, const size_t blocks) {
+    if (key.rounds == 14) chainRounds<14>(key, direction, in, out, blocks);
+    else chainRounds<10>(key, direction, in, out, blocks);
+}
+
+// Counter block i after the counter (high, low), stored big-endian
+AES_TARGET inline __m128i counterBlock(const uint64_t high, const uint64_t low, const uint64_t i) {
+    const uint64_t sum = low + i;
+    return _mm_set_epi64x(static_cast<long long>(__builtin_bswap64(sum)), static_cast<long long>(__builtin_bswap64(high + (sum < low))));
+}
+
+AES_TARGET void ctrBlocks(const Aes::Key& key, uint8_t* counter, const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint64_t high, low;
+    std::memcpy(&high, counter, 8);
+    std::memcpy(&low, counter + 8, 8);
+    high = __builtin_bswap64(high);
+    low = __builtin_bswap64(low);
+    const auto advance = [&](const uint64_t n) {
+        const uint64_t sum = low + n;
+        high += sum < low;
+        low = sum;
+    };
+    // Counters as little-endian qwords (low, high), byte-swapped into blocks; a group whose low half
+    // would wrap takes the scalar carry instead
+    const __m128i swap = _mm_set_epi64x(0x0001020304050607, 0x08090a0b0c0d0e0f);
+    for (; blocks >= IN_FLIGHT; blocks -= IN_FLIGHT, in += IN_FLIGHT * Aes::BLOCK, out += IN_FLIGHT * Aes::BLOCK) {
+        __m128i b[IN_FLIGHT];
+        if (low <= UINT64_MAX - IN_FLIGHT) {
+            const __m128i base = _mm_set_epi64x(static_cast<long long>(high), static_cast<long long>(low));
+#pragma GCC unroll 8
+            for (size_t j = 0; j < IN_FLIGHT; ++j) b[j] = _mm_shuffle_epi8(_mm_add_epi64(base, _mm_set_epi64x(0, j)), swap);
+        } else {
+#pragma GCC unroll 8
+            for (size_t j = 0; j < IN_FLIGHT; ++j) b[j] = counterBlock(high, low, j);
+        }
+        encryptBlocks<IN_FLIGHT>(b, reinterpret_cast<const __m128i*>(key.encrypt), key.rounds);
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) store(out + j * Aes::BLOCK, _mm_xor_si128(b[j], load(in + j * Aes::BLOCK)));
+        advance(IN_FLIGHT);
+    }
+    for (; blocks > 0; --blocks, in += Aes::BLOCK, out += Aes::BLOCK) {
+        __m128i b = counterBlock(high, low, 0);
+        encryptBlocks<1>(&b, reinterpret_cast<const __m128i*>(key.encrypt), key.rounds);
+        store(out, _mm_xor_si128(b, load(in)));
+        advance(1);
+    }
+    store(counter, counterBlock(high, low, 0));
+}
+
+// tweak * x in GF(2^128) mod x^128 + x^7 + x^2 + x + 1, the tweak a little-endian integer
+AES_TARGET inline __m128i doubleTweak(const __m128i tweak) {
+    const __m128i carries = _mm_shuffle_epi32(_mm_srai_epi32(tweak, 31), 0x13); // bit 127 to dword 0, bit 63 to dword 2
+    return _mm_xor_si128(_mm_add_epi64(tweak, tweak), _mm_and_si128(carries, _mm_set_epi32(0, 1, 0, 0x87)));
+}
+
+AES_TARGET inline __m128i firstTweak(const Aes::Key& tweak_key, const uint64_t unit) {
+    __m128i tweak = _mm_set_epi64x(0, static_cast<long long>(unit));
+    encryptBlocks<1>(&tweak, reinterpret_cast<const __m128i*>(tweak_key.encrypt), tweak_key.rounds);
+    return tweak;
+}
+
+AES_TARGET void xtsBlocks(const Aes::Key& data_key, const Aes::Direction direction, __m128i tweak, const uint8_t* in, uint8_t* out,
+                          size_t blocks) {
+    for (; blocks >= IN_FLIGHT; blocks -= IN_FLIGHT, in += IN_FLIGHT * Aes::BLOCK, out += IN_FLIGHT * Aes::BLOCK) {
+        __m128i b[IN_FLIGHT], t[IN_FLIGHT];
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) {
+            t[j] = tweak;
+            tweak = doubleTweak(tweak);
+            b[j] = _mm_xor_si128(load(in + j * Aes::BLOCK), t[j]);
+        }
+        cipherBlocks<IN_FLIGHT>(b, data_key, direction);
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) store(out + j * Aes::BLOCK, _mm_xor_si128(b[j], t[j]));
+    }
+    for (; blocks > 0; --blocks, in += Aes::BLOCK, out += Aes::BLOCK) {
+        __m128i b = _mm_xor_si128(load(in), tweak);
+        cipherBlocks<1>(&b, data_key, direction);
+        store(out, _mm_xor_si128(b, tweak));
+        tweak = doubleTweak(tweak);
+    }
+}
+
+// GHASH (SP 800-38D) multiplies in GF(2^128) with the bits of every byte reflected. Reversing the
+// bytes of each block makes the whole 128-bit order reflected, which pclmulqdq multiplies but one
+// bit short, so the sum of products is shifted left once and then reduced modulo
+// x^128 + x^7 + x^2 + x + 1 in two shift phases, the method of Intel's carry-less multiplication
+// white paper. The products of a group are summed unreduced: one reduction per group.
+#define GCM_TARGET __attribute__((target("aes,pclmul,avx")))
+
+GCM_TARGET inline __m128i reflect(const __m128i block) {
+    return _mm_shuffle_epi8(block, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+// Unreduced sum of products a * h by their 64-bit halves: a0h0, a0h1 ^ a1h0 and a1h1
+struct Product {
+    __m128i lo, mid, hi;
+};
+
+GCM_TARGET inline void multiplyAdd(Product& sum, const __m128i a, const __m128i h) {
+    sum.lo = _mm_xor_si128(sum.lo, _mm_clmulepi64_si128(a, h, 0x00));
+    sum.mid = _mm_xor_si128(sum.mid, _mm_xor_si128(_mm_clmulepi64_si128(a, h, 0x10), _mm_clmulepi64_si128(a, h, 0x01)));
+    sum.hi = _mm_xor_si128(sum.hi, _mm_clmulepi64_si128(a, h, 0x11));
+}
+
+GCM_TARGET inline __m128i reduce(const Product& sum) {
+    __m128i lo = _mm_xor_si128(sum.lo, _mm_slli_si128(sum.mid, 8));
+    __m128i hi = _mm_xor_si128(sum.hi, _mm_srli_si128(sum.mid, 8));
+    const __m128i lo_carries = _mm_srli_epi32(lo, 31), hi_carries = _mm_srli_epi32(hi, 31);
+    lo = _mm_or_si128(_mm_slli_epi32(lo, 1), _mm_slli_si128(lo_carries, 4));
+    hi = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(hi, 1), _mm_slli_si128(hi_carries, 4)), _mm_srli_si128(lo_carries, 12));
+    const __m128i left = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    lo = _mm_xor_si128(lo, _mm_slli_si128(left, 12));
+    const __m128i right = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    return _mm_xor_si128(hi, _mm_xor_si128(lo, _mm_xor_si128(right, _mm_srli_si128(left, 4))));
+}
+
+GCM_TARGET inline __m128i gfMul(const __m128i a, const __m128i h) {
+    Product product{_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+    multiplyAdd(product, a, h);
+    return reduce(product);
+}
+
+GCM_TARGET void gcmExpandKey(const uint8_t* key_bytes, const size_t key_bytes_size, Aes::GcmKey& out) {
+    expandKey(key_bytes, key_bytes_size, out.key);
+    __m128i h = _mm_setzero_si128();
+    encryptBlocks<1>(&h, reinterpret_cast<const __m128i*>(out.key.encrypt), out.key.rounds);
+    h = reflect(h);
+    __m128i power = h;
+    for (size_t i = Aes::GCM_POWERS; i-- > 0; power = gfMul(power, h)) store(out.powers[i], power);
+}
+
+// hash updated over whole blocks, IN_FLIGHT of them to a reduction
+GCM_TARGET void ghashBlocks(__m128i& hash, const Aes::GcmKey& key, const uint8_t* data, size_t blocks) {
+    const __m128i* powers = reinterpret_cast<const __m128i*>(key.powers);
+    for (; blocks >= IN_FLIGHT; blocks -= IN_FLIGHT, data += IN_FLIGHT * Aes::BLOCK) {
+        Product sum{_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) {
+            const __m128i block = reflect(load(data + j * Aes::BLOCK));
+            multiplyAdd(sum, j == 0 ? _mm_xor_si128(block, hash) : block, powers[Aes::GCM_POWERS - IN_FLIGHT + j]);
+        }
+        hash = reduce(sum);
+    }
+    for (; blocks > 0; --blocks, data += Aes::BLOCK) hash = gfMul(_mm_xor_si128(hash, reflect(load(data))), powers[Aes::GCM_POWERS - 1]);
+}
+
+// The last dword of j0 is the big-endian 32-bit block counter, which wraps on its own (inc32)
+GCM_TARGET inline __m128i gcmCounter(const __m128i j0, const uint32_t counter) {
+    return _mm_insert_epi32(j0, static_cast<int>(__builtin_bswap32(counter)), 3);
+}
+
+// CTR from counter on, and GHASH of the ciphertext: out when encrypting, in when decrypting
+GCM_TARGET void gcmBlocks(const Aes::GcmKey& key, const Aes::Direction direction, __m128i& hash, const __m128i j0, uint32_t& counter,
+                          const uint8_t* in, uint8_t* out, size_t blocks) {
+    const __m128i* keys = reinterpret_cast<const __m128i*>(key.key.encrypt);
+    const __m128i* powers = reinterpret_cast<const __m128i*>(key.powers);
+    const bool encrypt = direction == Aes::Direction::Encrypt;
+    for (; blocks >= IN_FLIGHT; blocks -= IN_FLIGHT, in += IN_FLIGHT * Aes::BLOCK, out += IN_FLIGHT * Aes::BLOCK) {
+        __m128i b[IN_FLIGHT];
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) b[j] = gcmCounter(j0, counter + static_cast<uint32_t>(j));
+        encryptBlocks<IN_FLIGHT>(b, keys, key.key.rounds);
+        Product sum{_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) {
+            const __m128i data = load(in + j * Aes::BLOCK);
+            b[j] = _mm_xor_si128(b[j], data);
+            store(out + j * Aes::BLOCK, b[j]);
+            const __m128i cipher = reflect(encrypt ? b[j] : data);
+            multiplyAdd(sum, j == 0 ? _mm_xor_si128(cipher, hash) : cipher, powers[Aes::GCM_POWERS - IN_FLIGHT + j]);
+        }
+        hash = reduce(sum);
+        counter += IN_FLIGHT;
+    }
+    for (; blocks > 0; --blocks, in += Aes::BLOCK, out += Aes::BLOCK) {
+        __m128i b = gcmCounter(j0, counter++);
+        encryptBlocks<1>(&b, keys, key.key.rounds);
+        const __m128i data = load(in);
+        b = _mm_xor_si128(b, data);
+        store(out, b);
+        hash = gfMul(_mm_xor_si128(hash, reflect(encrypt ? b : data)), powers[Aes::GCM_POWERS - 1]);
+    }
+}
+
+// VAES: one block per 128-bit lane of a ymm or zmm register. The traits carry the target of their
+// width, and the mode templates below are inlined into flattened wrappers of the same target, so
+// no AVX-512 instruction reaches the VAES-256 engine, which Zen 3 runs without AVX-512.
+#define VAES256_TARGET __attribute__((target("aes,vaes,avx2")))
+#define VAES512_TARGET __attribute__((target("aes,vaes,avx512f")))
+#define GCM256_TARGET __attribute__((target("aes,pclmul,vaes,vpclmulqdq,avx2")))
+#define GCM512_TARGET __attribute__((target("aes,pclmul,vaes,vpclmulqdq,avx512f,avx512bw")))
+
+// Byte shuffles within each block: whole-block reversal for GHASH, per-dword for GCM counters
+GCM_TARGET inline __m128i reflectMask() { return _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+GCM_TARGET inline __m128i swapDwordsMask() { return _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3); }
+
+struct Ymm {
+    using V = __m256i;
+    static constexpr size_t BLOCKS = 2;
+    VAES256_TARGET static void load(V& v, const uint8_t* bytes) { v = _mm256_loadu_si256(reinterpret_cast<const V*>(bytes)); }
+    VAES256_TARGET static void store(uint8_t* bytes, const V& v) { _mm256_storeu_si256(reinterpret_cast<V*>(bytes), v); }
+    VAES256_TARGET static void broadcast(V& v, const uint8_t* block) { v = _mm256_broadcastsi128_si256(::load(block)); }
+    VAES256_TARGET static void xorWith(V& v, const V& x) { v = _mm256_xor_si256(v, x); }
+    VAES256_TARGET static void enc(V& v, const V& key) { v = _mm256_aesenc_epi128(v, key); }
+    VAES256_TARGET static void encLast(V& v, const V& key) { v = _mm256_aesenclast_epi128(v, key); }
+    VAES256_TARGET static void dec(V& v, const V& key) { v = _mm256_aesdec_epi128(v, key); }
+    VAES256_TARGET static void decLast(V& v, const V& key) { v = _mm256_aesdeclast_epi128(v, key); }
+    // Counter blocks (high, low + lane), big-endian; the caller rules out a carry
+    VAES256_TARGET static void counters(V& v, const uint64_t high, const uint64_t low) {
+        const auto h = static_cast<long long>(high), l = static_cast<long long>(low);
+        const V swap = _mm256_set_epi64x(0x0001020304050607, 0x08090a0b0c0d0e0f, 0x0001020304050607, 0x08090a0b0c0d0e0f);
+        v = _mm256_shuffle_epi8(_mm256_set_epi64x(h, l + 1, h, l), swap);
+    }
+    // Each lane's tweak times x^k, 0 < k < 58: the k bits shifted out of the top fold back in
+    // through x^7 + x^2 + x + 1 without leaving the low qword
+    VAES256_TARGET static void mulX(V& out, const V& t, const int k) {
+        const V low_qwords = _mm256_set_epi64x(0, -1, 0, -1);
+        const V spill = _mm256_shuffle_epi32(_mm256_srli_epi64(t, 64 - k), 0x4e); // (top, carry into the high qword)
+        const V top = _mm256_and_si256(spill, low_qwords);
+        V r = _mm256_xor_si256(_mm256_slli_epi64(t, k), spill);
+        r = _mm256_xor_si256(r, _mm256_xor_si256(_mm256_slli_epi64(top, 1), _mm256_slli_epi64(top, 2)));
+        out = _mm256_xor_si256(r, _mm256_slli_epi64(top, 7));
+    }
+    // AES-GCM: j0 in every lane with the big-endian counters first + lane in its last dword
+    GCM256_TARGET static void gcmCounters(V& v, const V& j0, const uint32_t first) {
+        const V counts = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)), _mm256_set_epi32(1, 0, 0, 0, 0, 0, 0, 0));
+        v = _mm256_blend_epi32(j0, _mm256_shuffle_epi8(counts, _mm256_broadcastsi128_si256(swapDwordsMask())), 0x88);
+    }
+    GCM256_TARGET static void zero(V& v) { v = _mm256_setzero_si256(); }
+    GCM256_TARGET static void reflect(V& v) { v = _mm256_shuffle_epi8(v, _mm256_broadcastsi128_si256(reflectMask())); }
+    GCM256_TARGET static void xorFirst(V& v, const __m128i x) { v = _mm256_xor_si256(v, _mm256_zextsi128_si256(x)); }
+    GCM256_TARGET static void multiplyAdd(V& lo, V& mid, V& hi, const V& a, const V& h) {
+        lo = _mm256_xor_si256(lo, _mm256_clmulepi64_epi128(a, h, 0x00));
+        mid = _mm256_xor_si256(mid, _mm256_xor_si256(_mm256_clmulepi64_epi128(a, h, 0x10), _mm256_clmulepi64_epi128(a, h, 0x01)));
+        hi = _mm256_xor_si256(hi, _mm256_clmulepi64_epi128(a, h, 0x11));
+    }
+    // The lanes' partial sums added into one block
+    GCM256_TARGET static __m128i fold(const V& v) { return _mm_xor_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)); }
+};
+
+// GCC 12 flags the intrinsics' internal undefined operands when AVX-512 is enabled per function
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+struct Zmm {
+    using V = __m512i;
+    static constexpr size_t BLOCKS = 4;
+    VAES512_TARGET static void load(V& v, const uint8_t* bytes) { v = _mm512_loadu_si512(bytes); }
+    VAES512_TARGET static void store(uint8_t* bytes, const V& v) { _mm512_storeu_si512(bytes, v); }
+    VAES512_TARGET static void broadcast(V& v, const uint8_t* block) { v = _mm512_broadcast_i32x4(::load(block)); }
+    VAES512_TARGET static void xorWith(V& v, const V& x) { v = _mm512_xor_si512(v, x); }
+    VAES512_TARGET static void enc(V& v, const V& key) { v = _mm512_aesenc_epi128(v, key); }
+    VAES512_TARGET static void encLast(V& v, const V& key) { v = _mm512_aesenclast_epi128(v, key); }
+    VAES512_TARGET static void dec(V& v, const V& key) { v = _mm512_aesdec_epi128(v, key); }
+    VAES512_TARGET static void decLast(V& v, const V& key) { v = _mm512_aesdeclast_epi128(v, key); }
+    // Byte shuffles of zmm need AVX-512BW, so the counters are two ymm halves
+    VAES512_TARGET static void counters(V& v, const uint64_t high, const uint64_t low) {
+        Ymm::V lower, upper;
+        Ymm::counters(lower, high, low);
+        Ymm::counters(upper, high, low + 2);
+        v = _mm512_inserti64x4(_mm512_castsi256_si512(lower), upper, 1);
+    }
+    VAES512_TARGET static void mulX(V& out, const V& t, const int k) {
+        const V low_qwords = _mm512_set_epi64(0, -1, 0, -1, 0, -1, 0, -1);
+        const V spill = _mm512_shuffle_epi32(_mm512_srli_epi64(t, 64 - k), _MM_PERM_BADC);
+        const V top = _mm512_and_si512(spill, low_qwords);
+        V r = _mm512_xor_si512(_mm512_slli_epi64(t, k), spill);
+        r = _mm512_xor_si512(r, _mm512_xor_si512(_mm512_slli_epi64(top, 1), _mm512_slli_epi64(top, 2)));
+        out = _mm512_xor_si512(r, _mm512_slli_epi64(top, 7));
+    }
+    GCM512_TARGET static void gcmCounters(V& v, const V& j0, const uint32_t first) {
+        const V counts = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(first)),
+                                          _mm512_set_epi32(3, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0));
+        v = _mm512_mask_blend_epi32(0x8888, j0, _mm512_shuffle_epi8(counts, _mm512_broadcast_i32x4(swapDwordsMask())));
+    }
+    GCM512_TARGET static void zero(V& v) { v = _mm512_setzero_si512(); }
+    GCM512_TARGET static void reflect(V& v) { v = _mm512_shuffle_epi8(v, _mm512_broadcast_i32x4(reflectMask())); }
+    GCM512_TARGET static void xorFirst(V& v, const __m128i x) { v = _mm512_xor_si512(v, _mm512_zextsi128_si512(x)); }
+    GCM512_TARGET static void multiplyAdd(V& lo, V& mid, V& hi, const V& a, const V& h) {
+        lo = _mm512_xor_si512(lo, _mm512_clmulepi64_epi128(a, h, 0x00));
+        mid = _mm512_xor_si512(mid, _mm512_xor_si512(_mm512_clmulepi64_epi128(a, h, 0x10), _mm512_clmulepi64_epi128(a, h, 0x01)));
+        hi = _mm512_xor_si512(hi, _mm512_clmulepi64_epi128(a, h, 0x11));
+    }
+    GCM512_TARGET static __m128i fold(const V& v) {
+        const Ymm::V halves = _mm256_xor_si256(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1));
+        return _mm_xor_si128(_mm256_castsi256_si128(halves), _mm256_extracti128_si256(halves, 1));
+    }
+};
+
+// Round keys broadcast to every lane, all of them held across the call
+template <class W> inline void broadcastKeys(typename W::V* keys, const Aes::Key& key, const Aes::Direction direction) {
+    for (unsigned r = 0; r <= key.rounds; ++r) W::broadcast(keys[r], direction == Aes::Direction::Encrypt ? key.encrypt[r] : key.decrypt[r]);
+}
+
+template <class W> inline void cipherWide(typename W::V* b, const typename W::V* keys, const unsigned rounds, const Aes::Direction direction) {
+    if (direction == Aes::Direction::Encrypt) {
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) W::xorWith(b[j], keys[0]);
+        for (unsigned r = 1; r < rounds; ++r)
+#pragma GCC unroll 8
+            for (size_t j = 0; j < IN_FLIGHT; ++j) W::enc(b[j], keys[r]);
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) W::encLast(b[j], keys[rounds]);
+    } else {
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) W::xorWith(b[j], keys[rounds]);
+        for (unsigned r = rounds - 1; r > 0; --r)
+#pragma GCC unroll 8
+            for (size_t j = 0; j < IN_FLIGHT; ++j) W::dec(b[j], keys[r]);
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) W::decLast(b[j], keys[0]);
+    }
+}
+
+// Whole groups of IN_FLIGHT registers; the tail goes through the xmm engine
+template <class W> inline void ctrWide(const Aes::Key& key, uint8_t* counter, const uint8_t* in, uint8_t* out, size_t blocks) {
+    constexpr size_t GROUP = IN_FLIGHT * W::BLOCKS;
+    constexpr size_t BYTES = W::BLOCKS * Aes::BLOCK;
+    typename W::V keys[Aes::MAX_ROUNDS + 1];
+    broadcastKeys<W>(keys, key, Aes::Direction::Encrypt);
+    uint64_t high, low;
+    std::memcpy(&high, counter, 8);
+    std::memcpy(&low, counter + 8, 8);
+    high = __builtin_bswap64(high);
+    low = __builtin_bswap64(low);
+    for (; blocks >= GROUP; blocks -= GROUP, in += GROUP * Aes::BLOCK, out += GROUP * Aes::BLOCK) {
+        typename W::V b[IN_FLIGHT];
+        if (low <= UINT64_MAX - GROUP) {
+#pragma GCC unroll 8
+            for (size_t j = 0; j < IN_FLIGHT; ++j) W::counters(b[j], high, low + j * W::BLOCKS);
+        } else {
+            alignas(64) uint8_t blocks_bytes[GROUP * Aes::BLOCK];
+            for (size_t i = 0; i < GROUP; ++i) store(blocks_bytes + i * Aes::BLOCK, counterBlock(high, low, i));
+            for (size_t j = 0; j < IN_FLIGHT; ++j) W::load(b[j], blocks_bytes + j * BYTES);
+        }
+        cipherWide<W>(b, keys, key.rounds, Aes::Direction::Encrypt);
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) {
+            typename W::V data;
+            W::load(data, in + j * BYTES);
+            W::xorWith(b[j], data);
+            W::store(out + j * BYTES, b[j]);
+        }
+        const uint64_t sum = low + GROUP;
+        high += sum < low;
+        low = sum;
+    }
+    store(counter, counterBlock(high, low, 0));
+    ctrBlocks(key, counter, in, out, blocks);
+}
+
+template <class W>
+inline void xtsWide(const Aes::Key& data_key, const Aes::Direction direction, __m128i tweak, const uint8_t* in, uint8_t* out, size_t blocks) {
+    constexpr size_t GROUP = IN_FLIGHT * W::BLOCKS;
+    constexpr size_t BYTES = W::BLOCKS * Aes::BLOCK;
+    typename W::V keys[Aes::MAX_ROUNDS + 1];
+    broadcastKeys<W>(keys, data_key, direction);
+    // Lane i starts at tweak * x^i; register j of a group is its first register times x^(j * lanes)
+    alignas(64) uint8_t lanes[BYTES];
+    for (size_t i = 0; i < W::BLOCKS; ++i, tweak = doubleTweak(tweak)) store(lanes + i * Aes::BLOCK, tweak);
+    typename W::V first;
+    W::load(first, lanes);
+    for (; blocks >= GROUP; blocks -= GROUP, in += GROUP * Aes::BLOCK, out += GROUP * Aes::BLOCK) {
+        typename W::V b[IN_FLIGHT], t[IN_FLIGHT];
+        t[0] = first;
+#pragma GCC unroll 8
+        for (size_t j = 1; j < IN_FLIGHT; ++j) W::mulX(t[j], first, static_cast<int>(j * W::BLOCKS));
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) {
+            W::load(b[j], in + j * BYTES);
+            W::xorWith(b[j], t[j]);
+        }
+        cipherWide<W>(b, keys, data_key.rounds, direction);
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) {
+            W::xorWith(b[j], t[j]);
+            W::store(out + j * BYTES, b[j]);
+        }
+        W::mulX(first, first, GROUP);
+    }
+    W::store(lanes, first);
+    xtsBlocks(data_key, direction, load(lanes), in, out, blocks);
+}
+
+// Groups of IN_FLIGHT registers, their GHASH products summed over all lanes of the group before
+// the one reduction; the tail goes through the xmm engine
+template <class W>
+inline void gcmWide(const Aes::GcmKey& key, const Aes::Direction direction, __m128i& hash, const __m128i j0, uint32_t& counter,
+                    const uint8_t* in, uint8_t* out, size_t blocks) {
+    constexpr size_t GROUP = IN_FLIGHT * W::BLOCKS;
+    constexpr size_t BYTES = W::BLOCKS * Aes::BLOCK;
+    const bool encrypt = direction == Aes::Direction::Encrypt;
+    typename W::V keys[Aes::MAX_ROUNDS + 1], powers[IN_FLIGHT], iv;
+    broadcastKeys<W>(keys, key.key, Aes::Direction::Encrypt);
+#pragma GCC unroll 8
+    for (size_t j = 0; j < IN_FLIGHT; ++j) W::load(powers[j], key.powers[Aes::GCM_POWERS - GROUP + j * W::BLOCKS]);
+    alignas(16) uint8_t j0_bytes[Aes::BLOCK];
+    store(j0_bytes, j0);
+    W::broadcast(iv, j0_bytes);
+    for (; blocks >= GROUP; blocks -= GROUP, in += GROUP * Aes::BLOCK, out += GROUP * Aes::BLOCK) {
+        typename W::V b[IN_FLIGHT], lo, mid, hi;
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) W::gcmCounters(b[j], iv, counter + static_cast<uint32_t>(j * W::BLOCKS));
+        cipherWide<W>(b, keys, key.key.rounds, Aes::Direction::Encrypt);
+        W::zero(lo);
+        W::zero(mid);
+        W::zero(hi);
+#pragma GCC unroll 8
+        for (size_t j = 0; j < IN_FLIGHT; ++j) {
+            typename W::V data;
+            W::load(data, in + j * BYTES);
+            W::xorWith(b[j], data);
+            W::store(out + j * BYTES, b[j]);
+            typename W::V cipher = encrypt ? b[j] : data;
+            W::reflect(cipher);
+            if (j == 0) W::xorFirst(cipher, hash);
+            W::multiplyAdd(lo, mid, hi, cipher, powers[j]);
+        }
+        hash = reduce({W::fold(lo), W::fold(mid), W::fold(hi)});
+        counter += GROUP;
+    }
+    gcmBlocks(key, direction, hash, j0, counter, in, out, blocks);
+}
+
+VAES256_TARGET __attribute__((flatten)) void ctrVaes256(const Aes::Key& key, uint8_t* counter, const uint8_t* in, uint8_t* out,
+                                                         const size_t blocks) {
+    ctrWide<Ymm>(key, counter, in, out, blocks);
+}
+
+VAES512_TARGET __attribute__((flatten)) void ctrVaes512(const Aes::Key& key, uint8_t* counter, const uint8_t* in, uint8_t* out,
+                                                         const size_t blocks) {
+    ctrWide<Zmm>(key, counter, in, out, blocks);
+}
+
+VAES256_TARGET __attribute__((flatten)) void xtsVaes256(const Aes::Key& data_key, const Aes::Direction direction, const __m128i tweak,
+                                                         const uint8_t* in, uint8_t* out, const size_t blocks) {
+    xtsWide<Ymm>(data_key, direction, tweak, in, out, blocks);
+}
+
+VAES512_TARGET __attribute__((flatten)) void xtsVaes512(const Aes::Key& data_key, const Aes::Direction direction, const __m128i tweak,
+                                                         const uint8_t* in, uint8_t* out, const size_t blocks) {
+    xtsWide<Zmm>(data_key, direction, tweak, in, out, blocks);
+}
+
+GCM256_TARGET __attribute__((flatten)) void gcmVpclmul256(const Aes::GcmKey& key, const Aes::Direction direction, __m128i& hash,
+                                                           const __m128i j0, uint32_t& counter, const uint8_t* in, uint8_t* out,
+                                                           const size_t blocks) {
+    gcmWide<Ymm>(key, direction, hash, j0, counter, in, out, blocks);
+}
+
+GCM512_TARGET __attribute__((flatten)) void gcmVpclmul512(const Aes::GcmKey& key, const Aes::Direction direction, __m128i& hash,
+                                                           const __m128i j0, uint32_t& counter, const uint8_t* in, uint8_t* out,
+                                                           const size_t blocks) {
+    gcmWide<Zmm>(key, direction, hash, j0, counter, in, out, blocks);
+}
+#pragma GCC diagnostic pop
+
+// J0 = IV || 1: the data counts on from 2, and the tag is E(J0) xor GHASH over the aad, the
+// ciphertext and their bit lengths, each zero-padded to whole blocks
+GCM_TARGET void gcm(const Aes::GcmEngine engine, const Aes::GcmKey& key, const Aes::Direction direction, const uint8_t* iv,
+                    const uint8_t* aad, const size_t aad_bytes, const uint8_t* in, uint8_t* out, const size_t bytes, uint8_t* tag) {
+    alignas(16) uint8_t block[Aes::BLOCK] = {};
+    std::memcpy(block, iv, Aes::GCM_IV_BYTES);
+    block[Aes::BLOCK - 1] = 1;
+    const __m128i j0 = load(block);
+    const auto hashPartial = [&](__m128i& hash, const uint8_t* data, const size_t size) {
+        std::memset(block, 0, Aes::BLOCK);
+        std::memcpy(block, data, size);
+        ghashBlocks(hash, key, block, 1);
+    };
+
+    __m128i hash = _mm_setzero_si128();
+    ghashBlocks(hash, key, aad, aad_bytes / Aes::BLOCK);
+    if (aad_bytes % Aes::BLOCK) hashPartial(hash, aad + aad_bytes / Aes::BLOCK * Aes::BLOCK, aad_bytes % Aes::BLOCK);
+
+    uint32_t counter = 2;
+    const size_t blocks = bytes / Aes::BLOCK;
+    switch (engine) {
+    case Aes::GcmEngine::Vpclmul512: gcmVpclmul512(key, direction, hash, j0, counter, in, out, blocks); break;
+    case Aes::GcmEngine::Vpclmul256: gcmVpclmul256(key, direction, hash, j0, counter, in, out, blocks); break;
+    default: gcmBlocks(key, direction, hash, j0, counter, in, out, blocks); break;
+    }
+    if (const size_t rest = bytes % Aes::BLOCK) {
+        in += blocks * Aes::BLOCK;
+        out += blocks * Aes::BLOCK;
+        alignas(16) uint8_t data[Aes::BLOCK] = {}, result[Aes::BLOCK];
+        std::memcpy(data, in, rest);
+        __m128i b = gcmCounter(j0, counter);
+        encryptBlocks<1>(&b, reinterpret_cast<const __m128i*>(key.key.encrypt), key.key.rounds);
+        store(result, _mm_xor_si128(b, load(data)));
+        std::memcpy(out, result, rest);
+        hashPartial(hash, direction == Aes::Direction::Encrypt ? result : data, rest);
+    }
+
+    const __m128i lengths = _mm_set_epi64x(static_cast<long long>(__builtin_bswap64(uint64_t{bytes} * 8)),
+                                           static_cast<long long>(__builtin_bswap64(uint64_t{aad_bytes} * 8)));
+    hash = gfMul(_mm_xor_si128(hash, reflect(lengths)), load(key.powers[Aes::GCM_POWERS - 1]));
+    __m128i mask = j0;
+    encryptBlocks<1>(&mask, reinterpret_cast<const __m128i*>(key.key.encrypt), key.key.rounds);
+    store(tag, _mm_xor_si128(mask, reflect(hash)));
+}
+
+std::vector<uint8_t> parseHex(const char* hex) {
+    std::vector<uint8_t> bytes(std::strlen(hex) / 2);
+    const auto nibble = [](const char c) { return static_cast<uint8_t>(c <= '9' ? c - '0' : c - 'a' + 10); };
+    for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(nibble(hex[2 * i]) << 4 | nibble(hex[2 * i + 1]));
+    return bytes;
+}
+
+} // namespace
+
+Aes::Key Aes::expand(const uint8_t* key, const size_t key_bytes) {
+    Key expanded;
+    expandKey(key, key_bytes, expanded);
+    return expanded;
+}
+
+Aes::GcmKey Aes::gcmExpand(const uint8_t* key, const size_t key_bytes) {
+    GcmKey expanded;
+    gcmExpandKey(key, key_bytes, expanded);
+    return expanded;
+}
+
+void Aes::ecb(const Key& key, const Direction direction, const uint8_t* in, uint8_t* out, const size_t blocks) {
+    ecbBlocks(key, direction, in, out, blocks);
+}
+
+void Aes::blocks(const Key& key, const Direction direction, const BlockMode mode, const uint8_t* in, uint8_t* out, const size_t count) {
+    if (mode == BlockMode::Chain) chainBlocks(key, direction, in, out, count);
+    else ecbBlocks(key, direction, in, out, count);
+}
+
+void Aes::ctr(const Engine engine, const Key& key, uint8_t* counter, const uint8_t* in, uint8_t* out, const size_t blocks) {
+    switch (engine) {
+    case Engine::Vaes512: return ctrVaes512(key, counter, in, out, blocks);
+    case Engine::Vaes256: return ctrVaes256(key, counter, in, out, blocks);
+    default: return ctrBlocks(key, counter, in, out, blocks);
+    }
+}
+
+void Aes::xts(const Engine engine, const Key& data_key, const Key& tweak_key, const Direction direction, const uint64_t unit,
+              const uint8_t* in, uint8_t* out, const size_t blocks) {
+    const __m128i tweak = firstTweak(tweak_key, unit);
+    switch (engine) {
+    case Engine::Vaes512: return xtsVaes512(data_key, direction, tweak, in, out, blocks);
+    case Engine::Vaes256: return xtsVaes256(data_key, direction, tweak, in, out, blocks);
+    default: return xtsBlocks(data_key, direction, tweak, in, out, blocks);
+    }
+}
+
+size_t Aes::inFlight(const Engine engine) {
+    switch (engine) {
+    case Engine::Vaes512: return IN_FLIGHT * Zmm::BLOCKS;
+    case Engine::Vaes256: return IN_FLIGHT * Ymm::BLOCKS;
+    default: return IN_FLIGHT;
+    }
+}
+
+void Aes::gcmEncrypt(const GcmEngine engine, const GcmKey& key, const uint8_t* iv, const uint8_t* aad, const size_t aad_bytes,
+                     const uint8_t* in, uint8_t* out, const size_t bytes, uint8_t* tag) {
+    gcm(engine, key, Direction::Encrypt, iv, aad, aad_bytes, in, out, bytes, tag);
+}
+
+bool Aes::gcmDecrypt(const GcmEngine engine, const GcmKey& key, const uint8_t* iv, const uint8_t* aad, const size_t aad_bytes,
+                     const uint8_t* in, uint8_t* out, const size_t bytes, const uint8_t* tag) {
+    uint8_t expected[BLOCK];
+    gcm(engine, key, Direction::Decrypt, iv, aad, aad_bytes, in, out, bytes, expected);
+    uint8_t difference = 0;
+    for (size_t i = 0; i < BLOCK; ++i) difference |= expected[i] ^ tag[i];
+    return difference == 0;
+}
+
+size_t Aes::inFlight(const GcmEngine engine) {
+    switch (engine) {
+    case GcmEngine::Vpclmul512: return IN_FLIGHT * Zmm::BLOCKS;
+    case GcmEngine::Vpclmul256: return IN_FLIGHT * Ymm::BLOCKS;
+    default: return IN_FLIGHT;
+    }
+}
+
+bool Aes::selfTest(std::string& failure) {
+    // Checks both directions of one known answer; out of the decryption comes the plaintext back
+    const auto check = [&failure](const char* name, const std::vector<uint8_t>& plain, const std::vector<uint8_t>& cipher,
+                                  const auto& encrypt, const auto& decrypt) {
+        std::vector<uint8_t> out(plain.size());
+        encrypt(plain.data(), out.data());
+        if (out != cipher) {
+            failure = std::string(name) + ": wrong ciphertext";
+            return false;
+        }
+        decrypt(cipher.data(), out.data());
+        if (out != plain) {
+            failure = std::string(name) + ": wrong plaintext";
+            return false;
+        }
+        return true;
+    };
+    const auto ecbCheck = [&](const char* name, const char* key_hex, const char* plain_hex, const char* cipher_hex) {
+        const auto key_bytes = parseHex(key_hex);
+        const Key key = expand(key_bytes.data(), key_bytes.size());
+        const auto plain = parseHex(plain_hex);
+        return check(name, plain, parseHex(cipher_hex),
+                     [&](const uint8_t* in, uint8_t* out) { ecb(key, Direction::Encrypt, in, out, plain.size() / BLOCK); },
+                     [&](const uint8_t* in, uint8_t* out) { ecb(key, Direction::Decrypt, in, out, plain.size() / BLOCK); });
+    };
+    Engine engine = Engine::AesNiVex; // of the CTR and XTS checks
+    const auto ctrCheck = [&](const char* name, const char* key_hex, const char* counter_hex, const char* plain_hex, const char* cipher_hex) {
+        const auto key_bytes = parseHex(key_hex);
+        const Key key = expand(key_bytes.data(), key_bytes.size());
+        const auto plain = parseHex(plain_hex);
+        const auto apply = [&](const uint8_t* in, uint8_t* out) {
+            auto counter = parseHex(counter_hex);
+            ctr(engine, key, counter.data(), in, out, plain.size() / BLOCK);
+        };
+        return check(name, plain, parseHex(cipher_hex), apply, apply);
+    };
+    const auto xtsCheck = [&](const char* name, const char* key1_hex, const char* key2_hex, const uint64_t unit, const char* plain_hex,
+                              const char* cipher_hex) {
+        const auto key1 = parseHex(key1_hex), key2 = parseHex(key2_hex);
+        const Key data_key = expand(key1.data(), key1.size()), tweak_key = expand(key2.data(), key2.size());
+        const auto plain = parseHex(plain_hex);
+        return check(name, plain, parseHex(cipher_hex),
+                     [&](const uint8_t* in, uint8_t* out) { xts(engine, data_key, tweak_key, Direction::Encrypt, unit, in, out, plain.size() / BLOCK); },
+                     [&](const uint8_t* in, uint8_t* out) { xts(engine, data_key, tweak_key, Direction::Decrypt, unit, in, out, plain.size() / BLOCK); });
+    };
+
+    // FIPS 197 appendix C, SP 800-38A F.1 and F.5, IEEE 1619-2007 annex B vectors 1-3; the CTR and
+    // XTS ones on every engine
+    const char* SP800_38A_PLAIN = "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+                                  "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+    const char* SP800_38A_KEY128 = "2b7e151628aed2a6abf7158809cf4f3c";
+    const char* SP800_38A_KEY256 = "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4";
+    const char* SP800_38A_COUNTER = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+    if (!ecbCheck("FIPS 197 C.1", "000102030405060708090a0b0c0d0e0f", "00112233445566778899aabbccddeeff", "69c4e0d86a7b0430d8cdb78070b4c55a")
+        || !ecbCheck("FIPS 197 C.3", "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff",
+                     "8ea2b7ca516745bfeafc49904b496089")
+        || !ecbCheck("SP 800-38A ECB-AES128", SP800_38A_KEY128, SP800_38A_PLAIN,
+                     "3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf"
+                     "43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4")
+        || !ecbCheck("SP 800-38A ECB-AES256", SP800_38A_KEY256, SP800_38A_PLAIN,
+                     "f3eed1bdb5d2a03c064b5a7e3db181f8591ccb10d410ed26dc5ba74a31362870"
+                     "b6ed21b99ca6f4f9f153e7b1beafed1d23304b7a39f9f3ff067d8d8f9e24ecc7"))
+        return false;
+
+    const auto vectors = [&] {
+        return ctrCheck("SP 800-38A CTR-AES128", SP800_38A_KEY128, SP800_38A_COUNTER, SP800_38A_PLAIN,
+                        "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+                        "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee")
+            && ctrCheck("SP 800-38A CTR-AES256", SP800_38A_KEY256, SP800_38A_COUNTER, SP800_38A_PLAIN,
+                        "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+                        "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6")
+            && xtsCheck("IEEE 1619 XTS-AES-128 #1", "00000000000000000000000000000000", "00000000000000000000000000000000", 0,
+                        "0000000000000000000000000000000000000000000000000000000000000000",
+                        "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e")
+            && xtsCheck("IEEE 1619 XTS-AES-128 #2", "11111111111111111111111111111111", "22222222222222222222222222222222", 0x3333333333,
+                        "4444444444444444444444444444444444444444444444444444444444444444",
+                        "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0")
+            && xtsCheck("IEEE 1619 XTS-AES-128 #3", "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "22222222222222222222222222222222", 0x3333333333,
+                        "4444444444444444444444444444444444444444444444444444444444444444",
+                        "af85336b597afc1a900b2eb21ec949d292df4c047e0b21532186a5971a227a89");
+    };
+
+    // The vectors are shorter than a group; over several groups of the widest engine and a tail,
+    // the grouped paths and the block chain must agree with one block at a time, the counter must
+    // carry across its 64-bit halves, and each tweak must be the previous one doubled
+    constexpr size_t BLOCKS = 3 * 32 + 5;
+    std::vector<uint8_t> key_bytes(64), plain(BLOCKS * BLOCK), grouped(plain.size()), single(plain.size());
+    for (size_t i = 0; i < key_bytes.size(); ++i) key_bytes[i] = static_cast<uint8_t>(i * 29 + 7);
+    for (size_t i = 0; i < plain.size(); ++i) plain[i] = static_cast<uint8_t>(i * 167 + (i >> 8) * 13);
+    for (const size_t bytes : {size_t{16}, size_t{32}}) {
+        const Key key = expand(key_bytes.data(), bytes);
+        for (const Direction direction : {Direction::Encrypt, Direction::Decrypt}) {
+            ecb(key, direction, plain.data(), grouped.data(), BLOCKS);
+            for (size_t i = 0; i < BLOCKS; ++i) ecb(key, direction, plain.data() + i * BLOCK, single.data() + i * BLOCK, 1);
+            if (grouped != single) {
+                failure = "AES-" + std::to_string(bytes * 8) + " ECB: eight blocks in flight differ from one at a time";
+                return false;
+            }
+            blocks(key, direction, BlockMode::Chain, plain.data(), grouped.data(), BLOCKS);
+            ecb(key, direction, plain.data(), single.data(), 1);
+            for (size_t i = 1; i < BLOCKS; ++i) ecb(key, direction, single.data() + (i - 1) * BLOCK, single.data() + i * BLOCK, 1);
+            if (grouped != single) {
+                failure = "AES-" + std::to_string(bytes * 8) + " block chain: differs from feeding each ECB output back in";
+                return false;
+            }
+        }
+    }
+
+    for (const Engine candidate : {Engine::AesNiVex, Engine::Vaes256, Engine::Vaes512}) {
+        if (!CpuDispatch::get().supports(candidate)) continue;
+        engine = candidate;
+        if (!vectors()) {
+            failure = std::string(CpuDispatch::name(engine)) + " " + failure;
+            return false;
+        }
+        for (const size_t bytes : {size_t{16}, size_t{32}}) {
+            const Key key = expand(key_bytes.data(), bytes), tweak_key = expand(key_bytes.data() + 32, bytes);
+            const std::string name = std::string(CpuDispatch::name(engine)) + " AES-" + std::to_string(bytes * 8);
+
+            uint8_t counter[BLOCK], expected[BLOCK];
+            std::memset(counter, 0x5a, 8);
+            std::memset(counter + 8, 0xff, 8);
+            counter[15] = 0xf4; // the low half wraps inside the first group of every engine
+            std::vector<uint8_t> counters(plain.size());
+            for (size_t i = 0; i < BLOCKS; ++i) {
+                std::memcpy(counters.data() + i * BLOCK, counter, BLOCK);
+                for (int byte = BLOCK - 1; byte >= 0 && ++counter[byte] == 0; --byte) {}
+            }
+            std::memcpy(expected, counter, BLOCK);
+            std::memcpy(counter, counters.data(), BLOCK);
+            ctr(engine, key, counter, plain.data(), grouped.data(), BLOCKS);
+            ecb(key, Direction::Encrypt, counters.data(), single.data(), BLOCKS);
+            for (size_t i = 0; i < plain.size(); ++i) single[i] ^= plain[i];
+            if (grouped != single || std::memcmp(counter, expected, BLOCK) != 0) {
+                failure = name + " CTR: differs from ECB of the counter blocks";
+                return false;
+            }
+
+            uint8_t tweak[BLOCK] = {0x42};
+            ecb(tweak_key, Direction::Encrypt, tweak, tweak, 1);
+            for (const Direction direction : {Direction::Encrypt, Direction::Decrypt}) {
+                uint8_t t[BLOCK];
+                std::memcpy(t, tweak, BLOCK);
+                xts(engine, key, tweak_key, direction, 0x42, plain.data(), grouped.data(), BLOCKS);
+                for (size_t i = 0; i < BLOCKS; ++i) {
+                    uint8_t block[BLOCK];
+                    for (size_t b = 0; b < BLOCK; ++b) block[b] = plain[i * BLOCK + b] ^ t[b];
+                    ecb(key, direction, block, block, 1);
+                    for (size_t b = 0; b < BLOCK; ++b) single[i * BLOCK + b] = block[b] ^ t[b];
+                    const bool carry = t[BLOCK - 1] & 0x80;
+                    for (size_t b = BLOCK - 1; b > 0; --b) t[b] = static_cast<uint8_t>(t[b] << 1 | t[b - 1] >> 7);
+                    t[0] = static_cast<uint8_t>(t[0] << 1 ^ (carry ? 0x87 : 0));
+                }
+                if (grouped != single) {
+                    failure = name + " XTS: differs from one block at a time with doubled tweaks";
+                    return false;
+                }
+            }
+        }
+    }
+
+    // AES-GCM, the test cases of the GCM specification (McGrew and Viega) with 96-bit IVs, on every
+    // engine; then over several groups of the widest one, aad of a group and a tail, and a partial
+    // last block against ECB of the counter blocks and GHASH bit by bit (SP 800-38D algorithm 1)
+    GcmEngine gcm_engine = GcmEngine::Pclmul;
+    const auto gcmCheck = [&](const char* name, const char* key_hex, const char* iv_hex, const char* aad_hex, const char* plain_hex,
+                              const char* cipher_hex, const char* tag_hex) {
+        const auto key_bytes = parseHex(key_hex), iv = parseHex(iv_hex), aad = parseHex(aad_hex), plain = parseHex(plain_hex);
+        const auto expected_tag = parseHex(tag_hex);
+        const GcmKey key = gcmExpand(key_bytes.data(), key_bytes.size());
+        std::vector<uint8_t> tag(BLOCK);
+        bool authentic = false;
+        if (!check(name, plain, parseHex(cipher_hex),
+                   [&](const uint8_t* in, uint8_t* out) { gcmEncrypt(gcm_engine, key, iv.data(), aad.data(), aad.size(), in, out, plain.size(), tag.data()); },
+                   [&](const uint8_t* in, uint8_t* out) {
+                       authentic = gcmDecrypt(gcm_engine, key, iv.data(), aad.data(), aad.size(), in, out, plain.size(), expected_tag.data());
+                   }))
+            return false;
+        if (tag != expected_tag || !authentic) {
+            failure = std::string(name) + (authentic ? ": wrong tag" : ": decryption rejects the tag");
+            return false;
+        }
+        return true;
+    };
+    const char* GCM_KEY = "feffe9928665731c6d6a8f9467308308";
+    const char* GCM_IV = "cafebabefacedbaddecaf888";
+    const char* GCM_AAD = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+    const char* GCM_PLAIN = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525"
+                            "b16aedf5aa0de657ba637b391aafd255";
+    const char* GCM_PLAIN60 = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525"
+                              "b16aedf5aa0de657ba637b39";
+    const std::string gcm_key256 = std::string(GCM_KEY) + GCM_KEY;
+    const char* ZEROS = "00000000000000000000000000000000";
+    const auto gcmVectors = [&] {
+        return gcmCheck("GCM test case 1", ZEROS, "000000000000000000000000", "", "", "", "58e2fccefa7e3061367f1d57a4e7455a")
+            && gcmCheck("GCM test case 2", ZEROS, "000000000000000000000000", "", ZEROS, "0388dace60b6a392f328c2b971b2fe78",
+                        "ab6e47d42cec13bdf53a67b21257bddf")
+            && gcmCheck("GCM test case 3", GCM_KEY, GCM_IV, "", GCM_PLAIN,
+                        "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa05"
+                        "1ba30b396a0aac973d58e091473f5985",
+                        "4d5c2af327cd64a62cf35abd2ba6fab4")
+            && gcmCheck("GCM test case 4", GCM_KEY, GCM_IV, GCM_AAD, GCM_PLAIN60,
+                        "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa05"
+                        "1ba30b396a0aac973d58e091",
+                        "5bc94fbc3221a5db94fae95ae7121a47")
+            && gcmCheck("GCM test case 13", (std::string(ZEROS) + ZEROS).c_str(), "000000000000000000000000", "", "", "",
+                        "530f8afbc74536b9a963b4f1c4cb738b")
+            && gcmCheck("GCM test case 14", (std::string(ZEROS) + ZEROS).c_str(), "000000000000000000000000", "", ZEROS,
+                        "cea7403d4d606b6e074ec5d3baf39d18", "d0d1c8a799996bf0265b98b5d48ab919")
+            && gcmCheck("GCM test case 15", gcm_key256.c_str(), GCM_IV, "", GCM_PLAIN,
+                        "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838"
+                        "c5f61e6393ba7a0abcc9f662898015ad",
+                        "b094dac5d93471bdec1a502270e3cc6c")
+            && gcmCheck("GCM test case 16", gcm_key256.c_str(), GCM_IV, GCM_AAD, GCM_PLAIN60,
+                        "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838"
+                        "c5f61e6393ba7a0abcc9f662",
+                        "76fc6ece0f4e1768cddf8853bb2d551b");
+    };
+    // x = x * y in GHASH's bit order
+    const auto gfMulSerial = [](uint8_t* x, const uint8_t* y) {
+        uint8_t z[BLOCK] = {}, v[BLOCK];
+        std::memcpy(v, y, BLOCK);
+        for (size_t bit = 0; bit < 128; ++bit) {
+            if (x[bit / 8] >> (7 - bit % 8) & 1)
+                for (size_t b = 0; b < BLOCK; ++b) z[b] ^= v[b];
+            const bool low = v[BLOCK - 1] & 1;
+            for (size_t b = BLOCK - 1; b > 0; --b) v[b] = static_cast<uint8_t>(v[b] >> 1 | v[b - 1] << 7);
+            v[0] = static_cast<uint8_t>(v[0] >> 1 ^ (low ? 0xe1 : 0));
+        }
+        std::memcpy(x, z, BLOCK);
+    };
+    const size_t GCM_AAD_BYTES = IN_FLIGHT * BLOCK + 3, GCM_BYTES = plain.size() - 9;
+    for (const GcmEngine candidate : {GcmEngine::Pclmul, GcmEngine::Vpclmul256, GcmEngine::Vpclmul512}) {
+        if (!CpuDispatch::get().supports(candidate)) continue;
+        gcm_engine = candidate;
+        if (!gcmVectors()) {
+            failure = std::string(CpuDispatch::name(gcm_engine)) + " " + failure;
+            return false;
+        }
+        for (const size_t bytes : {size_t{16}, size_t{32}}) {
+            const GcmKey key = gcmExpand(key_bytes.data(), bytes);
+            const std::string name = std::string(CpuDispatch::name(gcm_engine)) + " AES-" + std::to_string(bytes * 8) + "-GCM";
+            const uint8_t* iv = key_bytes.data() + 40;
+            const std::vector<uint8_t> aad_bytes(plain.rbegin(), plain.rbegin() + GCM_AAD_BYTES);
+            const uint8_t* aad = aad_bytes.data();
+
+            uint8_t tag[BLOCK], expected[BLOCK], h[BLOCK] = {}, counter[BLOCK];
+            gcmEncrypt(gcm_engine, key, iv, aad, GCM_AAD_BYTES, plain.data(), grouped.data(), GCM_BYTES, tag);
+            std::vector<uint8_t> counters(plain.size());
+            std::memcpy(counter, iv, GCM_IV_BYTES);
+            for (uint32_t i = 0; i < BLOCKS; ++i) {
+                const uint32_t value = __builtin_bswap32(i + 2);
+                std::memcpy(counter + GCM_IV_BYTES, &value, 4);
+                std::memcpy(counters.data() + i * BLOCK, counter, BLOCK);
+            }
+            ecb(key.key, Direction::Encrypt, counters.data(), single.data(), BLOCKS);
+            for (size_t i = 0; i < GCM_BYTES; ++i) single[i] ^= plain[i];
+            ecb(key.key, Direction::Encrypt, h, h, 1);
+            uint8_t hash[BLOCK] = {};
+            const auto absorb = [&](const uint8_t* data, const size_t size) {
+                for (size_t at = 0; at < size; at += BLOCK) {
+                    for (size_t b = 0; b < BLOCK && at + b < size; ++b) hash[b] ^= data[at + b];
+                    gfMulSerial(hash, h);
+                }
+            };
+            absorb(aad, GCM_AAD_BYTES);
+            absorb(single.data(), GCM_BYTES);
+            uint8_t lengths[BLOCK];
+            for (size_t b = 0; b < 8; ++b) {
+                lengths[b] = static_cast<uint8_t>(uint64_t{GCM_AAD_BYTES} * 8 >> (56 - 8 * b));
+                lengths[8 + b] = static_cast<uint8_t>(uint64_t{GCM_BYTES} * 8 >> (56 - 8 * b));
+            }
+            absorb(lengths, BLOCK);
+            std::memcpy(counter + GCM_IV_BYTES, "\0\0\0\1", 4);
+            ecb(key.key, Direction::Encrypt, counter, expected, 1);
+            for (size_t b = 0; b < BLOCK; ++b) expected[b] ^= hash[b];
+            if (!std::equal(grouped.begin(), grouped.begin() + GCM_BYTES, single.begin()) || std::memcmp(tag, expected, BLOCK) != 0) {
+                failure = name + ": differs from ECB of the counter blocks and bitwise GHASH";
+                return false;
+            }
+            std::vector<uint8_t> decrypted(GCM_BYTES);
+            const bool authentic = gcmDecrypt(gcm_engine, key, iv, aad, GCM_AAD_BYTES, grouped.data(), decrypted.data(), GCM_BYTES, tag);
+            tag[BLOCK - 1] ^= 1;
+            const bool forged = gcmDecrypt(gcm_engine, key, iv, aad, GCM_AAD_BYTES, grouped.data(), decrypted.data(), GCM_BYTES, tag);
+            if (!authentic || forged || !std::equal(decrypted.begin(), decrypted.end(), plain.begin())) {
+                failure = name + ": decryption does not invert encryption or accepts a wrong tag";
+                return false;
+            }
+        }
+    }
+
+    // The asm entry points of core.hpp against the engine: AES-256 key expansion, single
+    // AES-128 blocks, and XTS-AES-256 from the encrypted first tweak
+    const Key key128 = expand(key_bytes.data(), 16), key256 = expand(key_bytes.data(), 32), tweak_key = expand(key_bytes.data() + 32, 32);
+    alignas(16) uint8_t schedule[15 * BLOCK];
+    aes256Keygen(schedule, key_bytes.data());
+    if (std::memcmp(schedule, key256.encrypt, sizeof(schedule)) != 0) {
+        failure = "aes256Keygen: wrong round keys";
+        return false;
+    }
+    uint8_t block[BLOCK], expected[BLOCK];
+    aes128EncryptBlock(block, plain.data(), key128.encrypt);
+    ecb(key128, Direction::Encrypt, plain.data(), expected, 1);
+    if (std::memcmp(block, expected, BLOCK) != 0) {
+        failure = "aes128EncryptBlock: wrong ciphertext";
+        return false;
+    }
+    aes128DecryptBlock(block, plain.data(), key128.decrypt);
+    ecb(key128, Direction::Decrypt, plain.data(), expected, 1);
+    if (std::memcmp(block, expected, BLOCK) != 0) {
+        failure = "aes128DecryptBlock: wrong plaintext";
+        return false;
+    }
+    uint8_t tweak[BLOCK] = {0x42};
+    ecb(tweak_key, Direction::Encrypt, tweak, tweak, 1);
+    aesXtsEncrypt(grouped.data(), plain.data(), key256.encrypt, tweak, BLOCKS);
+    xts(Engine::AesNiVex, key256, tweak_key, Direction::Encrypt, 0x42, plain.data(), single.data(), BLOCKS);
+    if (grouped != single) {
+        failure = "aesXtsEncrypt: wrong ciphertext";
+        return false;
+    }
+    aesXtsDecrypt(grouped.data(), plain.data(), key256.decrypt, tweak, BLOCKS);
+    xts(Engine::AesNiVex, key256, tweak_key, Direction::Decrypt, 0x42, plain.data(), single.data(), BLOCKS);
+    if (grouped != single) {
+        failure = "aesXtsDecrypt: wrong plaintext";
+        return false;
+    }
+    return true;
+}
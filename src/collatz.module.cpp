@@ -0,0 +1,240 @@
+#include "collatz.hpp"
+#include "core.hpp"
+#include "cpuDispatch.hpp"
+#include "runControl.hpp"
+#include "progress.hpp"
+#include <algorithm>
+
+uint64_t Collatz::steps(uint64_t n) {
+    uint64_t count = 0;
+    while (n > 1) {
+        n = n & 1 ? 3 * n + 1 : n >> 1;
+        ++count;
+    }
+    return count;
+}
+
+void Collatz::batch(const uint64_t* starts, uint64_t* steps, const size_t count) {
+    size_t done = 0;
+    switch (CpuDispatch::get().vector()) {
+    case CpuDispatch::Vector::Avx512:
+        done = count / 16 * 16;
+        p3np1Avx512(starts, steps, done);
+        break;
+    case CpuDispatch::Vector::Avx2:
+        done = count / 8 * 8;
+        p3np1Avx2(starts, steps, done);
+        break;
+    default:
+        break;
+    }
+    for (size_t i = done; i < count; ++i) steps[i] = Collatz::steps(starts[i]);
+}
+
+const char* Collatz::name() {
+    switch (CpuDispatch::get().vector()) {
+    case CpuDispatch::Vector::Avx512: return "AVX-512F, 16 lanes";
+    case CpuDispatch::Vector::Avx2: return "AVX2, 8 lanes";
+    default: return "scalar";
+    }
+}
+
+namespace {
+
+constexpr unsigned JUMP_BITS = 16;                // steps per jump-table lookup
+constexpr uint64_t JUMP_MASK = (1u << JUMP_BITS) - 1;
+constexpr uint64_t CACHE_LIMIT = 1u << 19;        // values with a cached step count
+constexpr uint64_t MIN_CHUNK = 1u << 14;          // starts per chunk, the stealing granularity
+
+// Jump table entry for residue r: k shortcut steps (odd: (3n+1)/2, even: n/2) take 2^k*h + r to
+// 3^odd * h + value, and cost k + odd plain steps. Valid while the trajectory cannot reach 1
+// within the jump, i.e. from any n >= 2^(k+1), which CACHE_LIMIT covers.
+struct Jump {
+    uint32_t value;
+    uint32_t odd;
+};
+
+struct Tables {
+    std::vector<Jump> jumps;
+    std::vector<uint16_t> steps; // plain step counts below CACHE_LIMIT
+    uint64_t pow3[JUMP_BITS + 1];
+
+    Tables() : jumps(1u << JUMP_BITS), steps(CACHE_LIMIT) {
+        pow3[0] = 1;
+        for (unsigned i = 1; i <= JUMP_BITS; ++i) pow3[i] = pow3[i - 1] * 3;
+        for (uint64_t r = 0; r <= JUMP_MASK; ++r) {
+            uint64_t v = r;
+            uint32_t odd = 0;
+            for (unsigned k = 0; k < JUMP_BITS; ++k) {
+                if (v & 1) {
+                    v = (3 * v + 1) / 2;
+                    ++odd;
+                } else {
+                    v /= 2;
+                }
+            }
+            jumps[r] = {static_cast<uint32_t>(v), odd};
+        }
+        // Every trajectory drops below its start, where the count is already known
+        steps[0] = steps[1] = 0;
+        for (uint64_t n = 2; n < CACHE_LIMIT; ++n) {
+            uint64_t v = n, count = 0;
+            while (v >= n) {
+                v = v & 1 ? 3 * v + 1 : v >> 1;
+                ++count;
+            }
+            steps[n] = static_cast<uint16_t>(count + steps[v]);
+        }
+    }
+};
+
+const Tables& tables() {
+    static const Tables instance;
+    return instance;
+}
+
+uint64_t wideSteps(unsigned __int128 n) {
+    uint64_t count = 0;
+    while (n > 1) {
+        n = n & 1 ? 3 * n + 1 : n >> 1;
+        ++count;
+    }
+    return count;
+}
+
+uint64_t trajectorySteps(uint64_t n, const Tables& t) {
+    uint64_t count = 0;
+    while (n >= CACHE_LIMIT) {
+        const Jump& jump = t.jumps[n & JUMP_MASK];
+        uint64_t next;
+        if (__builtin_mul_overflow(n >> JUMP_BITS, t.pow3[jump.odd], &next) || __builtin_add_overflow(next, jump.value, &next))
+            return count + wideSteps(n);
+        n = next;
+        count += JUMP_BITS + jump.odd;
+    }
+    return count + t.steps[n];
+}
+
+constexpr uint64_t pack(const uint64_t begin, const uint64_t end) { return end << 32 | begin; }
+constexpr uint64_t spanBegin(const uint64_t span) { return span & 0xffffffff; }
+constexpr uint64_t spanEnd(const uint64_t span) { return span >> 32; }
+
+} // namespace
+
+CollatzSweep::CollatzSweep(const uint64_t lower, const uint64_t upper, const unsigned threads)
+    : lower_(std::max<uint64_t>(lower, 1)), upper_(upper), shares_(threads), working_(threads) {
+    tables();
+    // Odd m in [ceil(lower / 2^a), upper / 2^a] for every a, merged into ascending intervals
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    for (unsigned a = 0; a < 64 && lower_ <= upper_ && (upper_ >> a) > 0; ++a) {
+        const uint64_t lo = (lower_ >> a) + ((lower_ & ((uint64_t{1} << a) - 1)) != 0);
+        const uint64_t hi = upper_ >> a;
+        if (lo <= hi) ranges.emplace_back(lo, hi);
+    }
+    std::ranges::sort(ranges);
+    std::vector<std::pair<uint64_t, uint64_t>> merged;
+    for (const auto& [lo, hi] : ranges) {
+        if (!merged.empty() && lo <= merged.back().second + 1) merged.back().second = std::max(merged.back().second, hi);
+        else merged.emplace_back(lo, hi);
+    }
+    for (const auto& [lo, hi] : merged) {
+        const uint64_t first = lo | 1;
+        if (first > hi) continue;
+        const uint64_t count = (hi - first) / 2 + 1;
+        intervals_.push_back({first, count, total_});
+        total_ += count;
+    }
+
+    chunk_size_ = std::max(MIN_CHUNK, total_ / (uint64_t{1} << 31) + 1);
+    chunk_count_ = (total_ + chunk_size_ - 1) / chunk_size_;
+    for (unsigned t = 0; t < threads; ++t)
+        shares_[t].span.store(pack(chunk_count_ * t / threads, chunk_count_ * (t + 1) / threads));
+}
+
+unsigned CollatzSweep::doublings(const uint64_t m) const { return 63 - __builtin_clzll(upper_ / m); }
+
+bool CollatzSweep::isStart(const uint64_t m) const { return m <= upper_ && (m << doublings(m)) >= lower_; }
+
+void CollatzSweep::sweepChunk(const uint64_t chunk, Share& share) const {
+    const Tables& t = tables();
+    const uint64_t begin = chunk * chunk_size_;
+    const uint64_t end = std::min(total_, begin + chunk_size_);
+    auto interval = std::ranges::upper_bound(intervals_, begin, {}, &Interval::before) - 1;
+    uint64_t m = interval->first + 2 * (begin - interval->before);
+    for (uint64_t p = begin; p < end; ++p, m += 2) {
+        if (p == interval->before + interval->count) m = (++interval)->first;
+        if (m % 3 == 2 && isStart((2 * m - 1) / 3)) {
+            ++share.skipped;
+            continue;
+        }
+        const unsigned a = doublings(m);
+        const uint64_t steps = trajectorySteps(m, t) + a;
+        const uint64_t witness = m << a;
+        if (!share.best.witness || steps > share.best.steps || (steps == share.best.steps && witness < share.best.witness)) share.best = {steps, witness};
+        ++share.starts;
+    }
+}
+
+bool CollatzSweep::steal(const unsigned thief) {
+    while (true) {
+        unsigned victim = thief;
+        uint64_t most = 0;
+        for (unsigned v = 0; v < shares_.size(); ++v) {
+            const uint64_t span = shares_[v].span.load(std::memory_order_relaxed);
+            if (spanEnd(span) > spanBegin(span) && spanEnd(span) - spanBegin(span) > most) {
+                most = spanEnd(span) - spanBegin(span);
+                victim = v;
+            }
+        }
+        if (most == 0) return false;
+        uint64_t span = shares_[victim].span.load();
+        const uint64_t begin = spanBegin(span), end = spanEnd(span);
+        if (end <= begin) continue;
+        const uint64_t mid = begin + (end - begin) / 2;
+        if (shares_[victim].span.compare_exchange_strong(span, pack(begin, mid))) {
+            shares_[thief].span.store(pack(mid, end));
+            return true;
+        }
+    }
+}
+
+void CollatzSweep::work(const unsigned thread, RunControl& run, ProgressCounter& progress) {
+    Share& share = shares_[thread];
+    while (!run.stopped()) {
+        uint64_t span = share.span.load();
+        if (spanBegin(span) >= spanEnd(span)) {
+            if (!steal(thread)) break;
+            continue;
+        }
+        if (!share.span.compare_exchange_weak(span, pack(spanBegin(span) + 1, spanEnd(span)))) continue;
+        const uint64_t before = share.starts;
+        sweepChunk(spanBegin(span), share);
+        chunks_done_.fetch_add(1);
+        progress.add(static_cast<double>(share.starts - before));
+    }
+    if (working_.fetch_sub(1) == 1) run.requestStop();
+}
+
+CollatzSweep::Best CollatzSweep::best() const {
+    Best best;
+    for (const auto& share : shares_) {
+        if (!share.best.witness) continue; // this thread started nothing
+        if (!best.witness || share.best.steps > best.steps || (share.best.steps == best.steps && share.best.witness < best.witness))
+            best = share.best;
+    }
+    return best;
+}
+
+uint64_t CollatzSweep::starts() const {
+    uint64_t total = 0;
+    for (const auto& share : shares_) total += share.starts;
+    return total;
+}
+
+uint64_t CollatzSweep::skipped() const {
+    uint64_t total = 0;
+    for (const auto& share : shares_) total += share.skipped;
+    return total;
+}
+
+uint64_t CollatzSweep::referenceSteps(const uint64_t n) { return wideSteps(n); }
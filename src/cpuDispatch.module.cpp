@@ -0,0 +1,235 @@
+#include "cpuDispatch.hpp"
+#include "core.hpp"
+#include <cpuid.h>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+
+constexpr uint64_t XCR0_SSE_AVX = 0x6;     // XMM and YMM state
+constexpr uint64_t XCR0_AVX512 = 0xe6;     // plus opmask and both halves of ZMM state
+
+// FLOPs of the avx kernels, tallied from their loops. Waves 1-12 are common to all variants:
+// per lane and iteration 104 (35 FMAs, 14 multiplies/adds, 9 rcp/rsqrt, 10 divides, one sqrt;
+// the SSE split of an FMA counts the same). Wave 13 of the AVX-512 variant adds 4 full and
+// 4 half-masked 16-lane FMAs.
+constexpr double AVX_ITERATIONS = 8192;
+constexpr double AVX_FLOPS_PER_LANE = 104;
+constexpr double AVX512_UPPER_BANK_FLOPS = (4 * 16 + 4 * 8) * 2;
+constexpr double AVX_UNITS_PER_FLOAT = 999448.0 / 64; // the avx score's historical instruction estimate
+
+// The throughput kernels: 12 chains of one instruction each per iteration (24 for AVX-512),
+// plus the loop's dec/jnz.
+constexpr double THROUGHPUT_ITERATIONS = 65536;
+constexpr double THROUGHPUT_CHAINS = 12;
+constexpr double THROUGHPUT_CHAINS_512 = 24;
+constexpr unsigned DEFAULT_FMA_PORTS = 2;
+
+uint64_t xgetbv() {
+    uint32_t eax, edx;
+    asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return static_cast<uint64_t>(edx) << 32 | eax;
+}
+
+std::string env(const char* name) {
+    const char* value = std::getenv(name);
+    return value ? value : "";
+}
+
+} // namespace
+
+CpuDispatch::CpuDispatch() {
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    const bool sse41 = ecx & bit_SSE4_1;
+    const bool osxsave = ecx & bit_OSXSAVE;
+    const uint64_t xcr0 = osxsave ? xgetbv() : 0;
+    const bool ymm_os = (xcr0 & XCR0_SSE_AVX) == XCR0_SSE_AVX;
+    const bool zmm_os = (xcr0 & XCR0_AVX512) == XCR0_AVX512;
+    features_.sse42 = ecx & bit_SSE4_2;
+    features_.aes = ecx & bit_AES;
+    features_.pclmul = ecx & bit_PCLMUL;
+    features_.avx = (ecx & bit_AVX) && ymm_os;
+    features_.fma = (ecx & bit_FMA) && ymm_os;
+
+    // Leaf 7 needs its subleaf; __get_cpuid leaves ecx undefined
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        features_.avx2 = (ebx & bit_AVX2) && ymm_os;
+        features_.avx512f = (ebx & bit_AVX512F) && zmm_os;
+        features_.avx512bw = (ebx & bit_AVX512BW) && zmm_os;
+        features_.bmi2 = ebx & bit_BMI2;
+        features_.vaes = (ecx & bit_VAES) && ymm_os;
+        features_.vpclmul = (ecx & bit_VPCLMULQDQ) && ymm_os;
+    }
+    // The sha256 kernel's own probe, so the SHA-NI engine and the legacy kernel agree on the host
+    features_.sha = check_sha_support() && sse41;
+
+    const std::string cap = env("ESST_ISA");
+    const std::string ports_env = env("ESST_FMA_PORTS");
+    const unsigned ports = std::atoi(ports_env.c_str()) > 0 ? std::atoi(ports_env.c_str()) : DEFAULT_FMA_PORTS;
+    if (features_.avx512f && (cap.empty() || cap == "avx512")) {
+        vector_ = Vector::Avx512;
+        avx_latency_ = {avx512, 16, AVX_ITERATIONS * (16 * AVX_FLOPS_PER_LANE + AVX512_UPPER_BANK_FLOPS), 16 * AVX_UNITS_PER_FLOAT};
+        avx_throughput_ = {avx512Throughput, 16, THROUGHPUT_ITERATIONS * THROUGHPUT_CHAINS_512 * 16 * 2,
+                           THROUGHPUT_ITERATIONS * (THROUGHPUT_CHAINS_512 + 2)};
+        peak_flops_per_cycle = ports * 16 * 2;
+    } else if (features_.avx2 && features_.fma && cap != "sse42") {
+        vector_ = Vector::Avx2;
+        avx_latency_ = {::avx, 8, AVX_ITERATIONS * 8 * AVX_FLOPS_PER_LANE, 8 * AVX_UNITS_PER_FLOAT};
+        avx_throughput_ = {avxThroughput, 8, THROUGHPUT_ITERATIONS * THROUGHPUT_CHAINS * 8 * 2,
+                           THROUGHPUT_ITERATIONS * (THROUGHPUT_CHAINS + 2)};
+        peak_flops_per_cycle = ports * 8 * 2;
+    } else if (features_.sse42) {
+        // Without FMA each port retires one 4-lane add or multiply per cycle
+        vector_ = Vector::Sse42;
+        avx_latency_ = {avxSse, 8, AVX_ITERATIONS * 8 * AVX_FLOPS_PER_LANE, 8 * AVX_UNITS_PER_FLOAT};
+        avx_throughput_ = {avxThroughputSse, 8, THROUGHPUT_ITERATIONS * THROUGHPUT_CHAINS * 4,
+                           THROUGHPUT_ITERATIONS * (THROUGHPUT_CHAINS + 2)};
+        peak_flops_per_cycle = ports * 4;
+    }
+
+    // VAES follows the vector cap, so ESST_ISA=avx2 also keeps AES off the zmm registers
+    const std::string aes = env("ESST_AES");
+    aes_ = supports(Aes::Vaes512) ? Aes::Vaes512 : supports(Aes::Vaes256) ? Aes::Vaes256 : supports(Aes::AesNiVex) ? Aes::AesNiVex : Aes::None;
+    for (const Aes engine : {Aes::AesNiVex, Aes::Vaes256, Aes::Vaes512})
+        if (aes == option(engine) && supports(engine)) aes_ = engine;
+
+    const std::string gcm = env("ESST_GCM");
+    gcm_ = supports(Gcm::Vpclmul512) ? Gcm::Vpclmul512 : supports(Gcm::Vpclmul256) ? Gcm::Vpclmul256 : supports(Gcm::Pclmul) ? Gcm::Pclmul : Gcm::None;
+    for (const Gcm engine : {Gcm::Pclmul, Gcm::Vpclmul256, Gcm::Vpclmul512})
+        if (gcm == option(engine) && supports(engine)) gcm_ = engine;
+
+    // Sixteen AVX-512 lanes outrun SHA-NI's single stream; eight AVX2 lanes do not
+    const std::string sha = env("ESST_SHA");
+    sha_ = supports(Sha::Avx512) ? Sha::Avx512 : supports(Sha::ShaNi) ? Sha::ShaNi : supports(Sha::Avx2) ? Sha::Avx2 : Sha::Software;
+    for (const Sha engine : {Sha::Software, Sha::Avx2, Sha::Avx512, Sha::ShaNi})
+        if (sha == option(engine) && supports(engine)) sha_ = engine;
+}
+
+bool CpuDispatch::supports(const Sha sha) const {
+    switch (sha) {
+    case Sha::Software: return true;
+    case Sha::Avx2: return vector_ == Vector::Avx2 || vector_ == Vector::Avx512;
+    case Sha::Avx512: return vector_ == Vector::Avx512;
+    case Sha::ShaNi: return features_.sha;
+    }
+    return false;
+}
+
+bool CpuDispatch::supports(const Aes aes) const {
+    const bool aes_ni = features_.aes && features_.avx;
+    switch (aes) {
+    case Aes::None: return true;
+    case Aes::AesNiVex: return aes_ni;
+    case Aes::Vaes256: return aes_ni && features_.vaes && (vector_ == Vector::Avx2 || vector_ == Vector::Avx512);
+    case Aes::Vaes512: return aes_ni && features_.vaes && vector_ == Vector::Avx512;
+    }
+    return false;
+}
+
+// The zmm GHASH byte-reflects its blocks with vpshufb, which takes AVX-512BW at that width
+bool CpuDispatch::supports(const Gcm gcm) const {
+    switch (gcm) {
+    case Gcm::None: return true;
+    case Gcm::Pclmul: return supports(Aes::AesNiVex) && features_.pclmul;
+    case Gcm::Vpclmul256: return supports(Aes::Vaes256) && features_.pclmul && features_.vpclmul;
+    case Gcm::Vpclmul512: return supports(Aes::Vaes512) && features_.pclmul && features_.vpclmul && features_.avx512bw;
+    }
+    return false;
+}
+
+const CpuDispatch& CpuDispatch::get() {
+    static const CpuDispatch dispatch;
+    return dispatch;
+}
+
+const char* CpuDispatch::name(const Vector vector) {
+    switch (vector) {
+    case Vector::None: return "none";
+    case Vector::Sse42: return "SSE4.2";
+    case Vector::Avx2: return "AVX2+FMA";
+    case Vector::Avx512: return "AVX-512F";
+    }
+    return "?";
+}
+
+const char* CpuDispatch::name(const Aes aes) {
+    switch (aes) {
+    case Aes::None: return "none";
+    case Aes::AesNiVex: return "AES-NI (VEX)";
+    case Aes::Vaes256: return "VAES-256 x16";
+    case Aes::Vaes512: return "VAES-512 x32";
+    }
+    return "?";
+}
+
+const char* CpuDispatch::name(const Gcm gcm) {
+    switch (gcm) {
+    case Gcm::None: return "none";
+    case Gcm::Pclmul: return "PCLMULQDQ x8";
+    case Gcm::Vpclmul256: return "VPCLMULQDQ-256 x16";
+    case Gcm::Vpclmul512: return "VPCLMULQDQ-512 x32";
+    }
+    return "?";
+}
+
+const char* CpuDispatch::name(const AvxMode mode) {
+    switch (mode) {
+    case AvxMode::Latency: return "latency";
+    case AvxMode::Throughput: return "throughput";
+    }
+    return "?";
+}
+
+const char* CpuDispatch::name(const Sha sha) {
+    switch (sha) {
+    case Sha::Software: return "software";
+    case Sha::Avx2: return "AVX2 x8";
+    case Sha::Avx512: return "AVX-512F x16";
+    case Sha::ShaNi: return "SHA-NI";
+    }
+    return "?";
+}
+
+const char* CpuDispatch::option(const Sha sha) {
+    switch (sha) {
+    case Sha::Software: return "software";
+    case Sha::Avx2: return "avx2";
+    case Sha::Avx512: return "avx512";
+    case Sha::ShaNi: return "shani";
+    }
+    return "?";
+}
+
+const char* CpuDispatch::option(const Aes aes) {
+    switch (aes) {
+    case Aes::None: return "none";
+    case Aes::AesNiVex: return "aesni";
+    case Aes::Vaes256: return "vaes256";
+    case Aes::Vaes512: return "vaes512";
+    }
+    return "?";
+}
+
+const char* CpuDispatch::option(const Gcm gcm) {
+    switch (gcm) {
+    case Gcm::None: return "none";
+    case Gcm::Pclmul: return "pclmul";
+    case Gcm::Vpclmul256: return "vpclmul256";
+    case Gcm::Vpclmul512: return "vpclmul512";
+    }
+    return "?";
+}
+
+std::string CpuDispatch::featureSummary() const {
+    const auto flag = [](const char* label, const bool present) { return std::string(label) + (present ? "+" : "-"); };
+    return flag("SSE4.2", features_.sse42) + " | " + flag("AVX", features_.avx) + " | " + flag("AVX2", features_.avx2)
+         + " | " + flag("FMA", features_.fma) + " | " + flag("AVX-512F", features_.avx512f) + " | "
+         + flag("AES-NI", features_.aes) + " | " + flag("VAES", features_.vaes) + " | " + flag("PCLMUL", features_.pclmul)
+         + " | " + flag("VPCLMUL", features_.vpclmul) + " | " + flag("SHA-NI", features_.sha)
+         + " | " + flag("BMI2", features_.bmi2);
+}
+
+std::string CpuDispatch::kernelSummary() const {
+    return std::string("avx ") + name(vector_) + " | aes " + name(aes_) + " | gcm " + name(gcm_) + " | sha " + name(sha_);
+}
@@ -0,0 +1,185 @@
+#include "cpuFrequency.hpp"
+#include <chrono>
+#include <fcntl.h>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <unistd.h>
+#include <x86intrin.h>
+
+namespace {
+
+constexpr uint32_t MSR_MPERF = 0xE7;
+constexpr uint32_t MSR_APERF = 0xE8;
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(500);
+constexpr uint64_t BUSY_LOOP_ROUNDS = 1 << 16; // 32 dependent adds each, ~2M cycles
+constexpr double BUSY_LOOP_ADDS = 32.0;
+
+int openMsr(const int cpu) {
+    return open(("/dev/cpu/" + std::to_string(cpu) + "/msr").c_str(), O_RDONLY);
+}
+
+bool readMsr(const int fd, const uint32_t reg, uint64_t& value) {
+    return fd >= 0 && pread(fd, &value, sizeof(value), reg) == sizeof(value);
+}
+
+std::optional<double> scalingCurMHz(const int cpu) {
+    std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq");
+    double khz;
+    if (!(file >> khz)) return std::nullopt;
+    return khz / 1000.0;
+}
+
+} // namespace
+
+FrequencySampler::FrequencySampler(std::vector<int> cpus)
+    : cpus_(std::move(cpus)), source_(detect()), result_(cpus_.size(), 0.0) {}
+
+FrequencySampler::~FrequencySampler() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (poller_.joinable()) poller_.join();
+    for (const int fd : msr_fds_) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+FrequencySampler::Source FrequencySampler::detect() {
+    static const Source source = [] {
+        const int fd = openMsr(0);
+        uint64_t value;
+        const bool msr = readMsr(fd, MSR_APERF, value) && readMsr(fd, MSR_MPERF, value);
+        if (fd >= 0) close(fd);
+        if (msr) return Source::AperfMperf;
+        if (scalingCurMHz(0)) return Source::ScalingCurFreq;
+        return Source::BusyLoop;
+    }();
+    return source;
+}
+
+const char* FrequencySampler::name(const Source source) {
+    switch (source) {
+    case Source::AperfMperf: return "APERF/MPERF";
+    case Source::ScalingCurFreq: return "scaling_cur_freq";
+    case Source::BusyLoop: return "TSC busy loop";
+    }
+    return "?";
+}
+
+double FrequencySampler::tscHz() {
+    static const double hz = [] {
+        const auto t0 = std::chrono::steady_clock::now();
+        const uint64_t c0 = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const uint64_t c1 = __rdtsc();
+        const auto t1 = std::chrono::steady_clock::now();
+        return (c1 - c0) / std::chrono::duration<double>(t1 - t0).count();
+    }();
+    return hz;
+}
+
+double FrequencySampler::busyLoopMHz() {
+    const double hz = tscHz();
+    uint64_t x = 0;
+    const uint64_t one = 1;
+    const uint64_t begin = __rdtsc();
+    for (uint64_t i = 0; i < BUSY_LOOP_ROUNDS; ++i) {
+        // One add per cycle: each depends on the previous one. Register operand, because newer
+        // cores fold chains of add-immediate at rename and retire several per cycle.
+        asm volatile(".rept 32\n\tadd %1, %0\n\t.endr" : "+r"(x) : "r"(one));
+    }
+    const double seconds = (__rdtsc() - begin) / hz;
+    return BUSY_LOOP_ROUNDS * BUSY_LOOP_ADDS / seconds / 1e6;
+}
+
+double FrequencySampler::currentMHz() {
+    double sum = 0;
+    unsigned count = 0;
+    for (int cpu = 0; const auto mhz = scalingCurMHz(cpu); ++cpu) {
+        sum += *mhz;
+        ++count;
+    }
+    if (count == 0) {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (!line.starts_with("cpu MHz")) continue;
+            sum += std::stod(line.substr(line.find(':') + 1));
+            ++count;
+        }
+    }
+    return count ? sum / count : 0.0;
+}
+
+void FrequencySampler::start() {
+    switch (source_) {
+    case Source::AperfMperf:
+        aperf_.assign(cpus_.size(), 0);
+        mperf_.assign(cpus_.size(), 0);
+        for (size_t i = 0; i < cpus_.size(); ++i) {
+            msr_fds_.push_back(openMsr(cpus_[i]));
+            readMsr(msr_fds_[i], MSR_APERF, aperf_[i]);
+            readMsr(msr_fds_[i], MSR_MPERF, mperf_[i]);
+        }
+        break;
+
+    case Source::ScalingCurFreq:
+        sum_mhz_.assign(cpus_.size(), 0.0);
+        samples_.assign(cpus_.size(), 0);
+        poller_ = std::thread([this] {
+            std::unique_lock lock(mutex_);
+            while (!wake_.wait_for(lock, POLL_INTERVAL, [this] { return stopping_; })) {
+                for (size_t i = 0; i < cpus_.size(); ++i) {
+                    if (const auto mhz = scalingCurMHz(cpus_[i])) {
+                        sum_mhz_[i] += *mhz;
+                        ++samples_[i];
+                    }
+                }
+            }
+        });
+        break;
+
+    case Source::BusyLoop:
+        tscHz(); // calibrate here, not on a worker
+        break;
+    }
+}
+
+void FrequencySampler::stop() {
+    switch (source_) {
+    case Source::AperfMperf:
+        for (size_t i = 0; i < cpus_.size(); ++i) {
+            uint64_t aperf, mperf;
+            if (!readMsr(msr_fds_[i], MSR_APERF, aperf) || !readMsr(msr_fds_[i], MSR_MPERF, mperf)) continue;
+            // MPERF ticks at the TSC rate while the core is in C0, APERF at the actual clock
+            if (mperf > mperf_[i]) result_[i] = tscHz() * (aperf - aperf_[i]) / (mperf - mperf_[i]) / 1e6;
+        }
+        break;
+
+    case Source::ScalingCurFreq:
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (poller_.joinable()) poller_.join();
+        for (size_t i = 0; i < cpus_.size(); ++i) {
+            result_[i] = samples_[i] ? sum_mhz_[i] / samples_[i] : scalingCurMHz(cpus_[i]).value_or(0.0);
+        }
+        break;
+
+    case Source::BusyLoop:
+        break;
+    }
+}
+
+void FrequencySampler::measureHere(const size_t index) {
+    if (source_ == Source::BusyLoop && index < result_.size()) result_[index] = busyLoopMHz();
+}
+
+std::vector<double> FrequencySampler::mhz() const {
+    return result_;
+}
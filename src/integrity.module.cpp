@@ -0,0 +1,93 @@
+#include "integrity.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+void Digest::add(const void* data, const size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        state_ ^= bytes[i];
+        state_ *= 0x100000001b3ull;
+    }
+}
+
+IntegrityCheck::IntegrityCheck(std::string kernel, const unsigned threads, const int reference_cpu)
+    : kernel_(std::move(kernel)), reference_cpu_(reference_cpu), threads_(threads) {}
+
+bool IntegrityCheck::verify(const unsigned thread, const uint64_t iteration, const uint64_t digest) {
+    auto& log = threads_[thread];
+    const unsigned round = iteration % ROUNDS;
+    if (!log.seen[round]) {
+        log.first[round] = digest;
+        log.seen[round] = true;
+    }
+    ++log.checked;
+    if (digest == reference_[round]) return true;
+    ++log.failed;
+    if (log.logged.size() < MAX_LOGGED) log.logged.push_back({iteration, round, reference_[round], digest});
+    return false;
+}
+
+uint64_t IntegrityCheck::mismatches() const {
+    uint64_t total = 0;
+    for (const auto& log : threads_) total += log.failed;
+    return total;
+}
+
+bool IntegrityCheck::report(std::ostream& out, const std::vector<int>& cpus) const {
+    const auto flags = out.flags();
+    const auto hex = [](const uint64_t value) {
+        std::ostringstream s;
+        s << "0x" << std::hex << std::setw(16) << std::setfill('0') << value;
+        return s.str();
+    };
+
+    out << "\n====== SDC CHECK (" << kernel_ << ", " << ROUNDS << " seeded rounds, reference from CPU "
+        << reference_cpu_ << " at low load) ======\n";
+    for (size_t t = 0; t < threads_.size(); ++t) {
+        const auto& log = threads_[t];
+        out << "Thread " << t << " (CPU " << cpus[t] << "): " << log.checked << " rounds checked, "
+            << log.failed << " mismatches" << (log.failed ? "  <-- CORRUPTION" : "") << "\n";
+        for (const auto& m : log.logged) {
+            out << "    iteration " << m.iteration << " (round " << m.round << "): got " << hex(m.actual)
+                << ", expected " << hex(m.expected) << "\n";
+        }
+        if (log.failed > log.logged.size()) out << "    ... " << log.failed - log.logged.size() << " more\n";
+    }
+
+    // Cross-core: the digest most cores produced first for each round
+    bool cores_agree = true;
+    if (threads_.size() > 1) {
+        for (unsigned round = 0; round < ROUNDS; ++round) {
+            std::map<uint64_t, unsigned> votes;
+            for (const auto& log : threads_) {
+                if (log.seen[round]) ++votes[log.first[round]];
+            }
+            if (votes.empty()) continue;
+            const auto consensus = std::ranges::max_element(votes, {}, &std::pair<const uint64_t, unsigned>::second);
+            unsigned seen = 0;
+            for (const auto& [digest, count] : votes) seen += count;
+            if (votes.size() == 1 && consensus->first != reference_[round] && seen > 1) {
+                cores_agree = false;
+                out << "Round " << round << ": all " << seen << " cores agree on " << hex(consensus->first)
+                    << " but not with the reference: the reference run on CPU " << reference_cpu_ << " is suspect\n";
+            }
+            for (size_t t = 0; t < threads_.size(); ++t) {
+                const auto& log = threads_[t];
+                if (!log.seen[round] || log.first[round] == consensus->first) continue;
+                cores_agree = false;
+                out << "Round " << round << ": CPU " << cpus[t] << " differs from the other "
+                    << consensus->second << " core(s)\n";
+            }
+        }
+        if (cores_agree) out << "Cross-core: every core produced the same digest for every round it completed\n";
+    }
+
+    const uint64_t failed = mismatches();
+    out << "Verdict: " << (failed == 0 && cores_agree ? "PASS" : "FAIL");
+    if (failed) out << " (" << failed << " corrupted rounds)";
+    out << "\n";
+    out.flags(flags);
+    return failed == 0 && cores_agree;
+}
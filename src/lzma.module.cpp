@@ -7,28 +7,32 @@
 #include <memory>
 #include <algorithm>
 #include <cstring>
+#include <iomanip>
 #include <zlib.h>
 #include <lzma.h>
+#include "workerPool.hpp"
+#include "resultLog.hpp"
+#include "pcgLanes.hpp"
 
 class CompressNDecompress {
 private:
     std::atomic<bool> running{false};
     std::atomic<uint64_t> total_operations{0};
     std::atomic<uint64_t> total_bytes_processed{0};
-    std::vector<std::thread> worker_threads;
     
     // Generate pseudo-random but compressible data
+    // One 32-bit draw per byte: the low 8 bits are the random byte, the upper 24 pick random vs pattern.
     std::vector<uint8_t> generate_mixed_data(size_t size, double entropy = 0.7) {
         std::vector<uint8_t> data(size);
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 255);
-        std::uniform_real_distribution<> entropy_dis(0.0, 1.0);
+        std::vector<uint32_t> words(size);
+        PcgLanes gen(std::random_device{}(), 0);
+        gen.fill(words.data(), size);
+        const auto threshold = static_cast<uint32_t>(entropy * (1u << 24));
         
         for (size_t i = 0; i < size; ++i) {
-            if (entropy_dis(gen) < entropy) {
+            if ((words[i] >> 8) < threshold) {
                 // Random data (harder to compress)
-                data[i] = dis(gen);
+                data[i] = static_cast<uint8_t>(words[i]);
             } else {
                 // Repeated patterns (easier to compress)
                 data[i] = (i % 16) * 16 + (i % 4);
@@ -105,8 +109,8 @@ private:
     }
     
     // Multi-pass compression worker
-    void compression_worker(const int worker_id, const size_t data_size, const int algorithm_mix) {
-        std::cout << "Thread " << worker_id << " starting compression...\n";
+    void compression_worker(const int worker_id, const size_t data_size, const int algorithm_mix, const bool quiet) {
+        if (!quiet) std::cout << "Thread " << worker_id << " starting compression...\n";
         
         uint64_t local_ops = 0;
         uint64_t local_bytes = 0;
@@ -154,71 +158,83 @@ private:
         total_operations.fetch_add(local_ops);
         total_bytes_processed.fetch_add(local_bytes);
         
-        std::cout << "Thread " << worker_id << " finished.\n";
+        if (!quiet) std::cout << "Thread " << worker_id << " finished.\n";
     }
     
 public:
-    void start(int duration_seconds = 60, 
-                           size_t chunk_size = 1024 * 512) {
-        
+    // Runs the test for duration_seconds and returns the achieved throughput in bytes/s.
+    // num_threads == 0 uses every pool worker; worker i runs on pool worker first_core + i.
+    // quiet suppresses the banner and progress line, for runs that share the console with other kernels.
+    double start(int duration_seconds = 60,
+                 size_t chunk_size = 1024 * 512,
+                 unsigned int num_threads = 0,
+                 unsigned int first_core = 0,
+                 bool quiet = false) {
+
         if (running.load()) {
             std::cout << "Compression stress already running!\n";
-            return;
+            return 0.0;
         }
-        
+
         running.store(true);
         total_operations.store(0);
         total_bytes_processed.store(0);
-        
-        unsigned int num_threads = std::thread::hardware_concurrency();
-        if (num_threads == 0) num_threads = 8;
-        
-        std::cout << "Starting compression stress test:\n";
-        std::cout << "- Threads: " << num_threads << "\n";
-        std::cout << "- Chunk size: " << chunk_size / 1024 << "KB\n";
-        std::cout << "- Duration: " << duration_seconds << " seconds\n";
-        std::cout << "- Algorithms: LZMA (level 9) + DEFLATE (max)\n\n";
-        
-        // Launch worker threads
-        worker_threads.clear();
+
+        WorkerPool& pool = WorkerPool::shared();
+        if (num_threads == 0) num_threads = pool.size();
+
+        if (!quiet) {
+            std::cout << "Starting compression stress test:\n";
+            std::cout << "- Threads: " << num_threads << "\n";
+            std::cout << "- Chunk size: " << chunk_size / 1024 << "KB\n";
+            std::cout << "- Duration: " << duration_seconds << " seconds\n";
+            std::cout << "- Algorithms: LZMA (level 9) + DEFLATE (max)\n\n";
+        }
+
+        // Launch workers on the shared pinned pool
+        WorkerPool::Group workers;
         for (unsigned int i = 0; i < num_threads; ++i) {
-            worker_threads.emplace_back(&CompressNDecompress::compression_worker, 
-                                      this, i, chunk_size, 3);
+            pool.submit(workers, first_core + i, [this, i, chunk_size, quiet] {
+                compression_worker(i, chunk_size, 3, quiet);
+            });
         }
-        
+
         // Run for a specified duration with progress updates
         auto start_time = std::chrono::steady_clock::now();
         for (int elapsed = 0; elapsed < duration_seconds; ++elapsed) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
-            
+            if (quiet) continue;
+
             auto ops = total_operations.load();
             auto bytes = total_bytes_processed.load();
             double mb_per_sec = (bytes / (1024.0 * 1024.0)) / (elapsed + 1);
-            
+
             std::cout << "Progress: " << elapsed + 1 << "s | "
                       << "Operations: " << ops << " | "
-                      << "Throughput: " << std::fixed << std::setprecision(1) 
+                      << "Throughput: " << std::fixed << std::setprecision(1)
                       << mb_per_sec << " MB/s\r" << std::flush;
         }
-        
-        std::cout << "\nStopping compression stress...\n";
+
+        if (!quiet) std::cout << "\nStopping compression stress...\n";
         running.store(false);
-        
-        // Wait for all threads to finish
-        for (auto& thread : worker_threads) {
-            thread.join();
-        }
-        
+
+        // Wait for all workers to finish
+        workers.wait();
+
         // Final statistics
         auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - start_time).count();
-        
+        const double bytes_per_sec = total_bytes_processed.load() / (total_time / 1000.0);
+        ResultLog::shared().record({"lzma", -1, -1, bytes_per_sec, "B/s", total_time / 1000.0});
+        if (quiet) return bytes_per_sec;
+
         std::cout << "\n=== COMPRESSION STRESS RESULTS ===\n";
         std::cout << "Total operations: " << total_operations.load() << "\n";
         std::cout << "Total data processed: " << total_bytes_processed.load() / (1024*1024) << " MB\n";
-        std::cout << "Average throughput: " << (total_bytes_processed.load() / (1024.0*1024.0)) / (total_time/1000.0) << " MB/s\n";
+        std::cout << "Average throughput: " << bytes_per_sec / (1024.0*1024.0) << " MB/s\n";
         std::cout << "Operations per second: " << (total_operations.load() * 1000.0) / total_time << "\n";
         std::cout << "====================================\n\n";
+        return bytes_per_sec;
     }
     
     void stop() {
@@ -235,3 +251,9 @@ extern "C" void startLZMA(const int duration) {
     CompressNDecompress test;
     test.start(duration, 1024 * 512);
 }
+
+// Partitioned run used by the concurrent stress mode: threads pinned to [first_core, first_core + threads).
+extern "C" double startLZMAPartition(const int duration, const unsigned threads, const unsigned first_core) {
+    CompressNDecompress test;
+    return test.start(duration, 1024 * 512, threads, first_core, true);
+}
@@ -1,5 +1,21 @@
 #include "core.hpp"
 #include "pcg_random.hpp"
+#include "workerPool.hpp"
+#include "runControl.hpp"
+#include "topology.hpp"
+#include "progress.hpp"
+#include "statistics.hpp"
+#include "resultLog.hpp"
+#include "cpuFrequency.hpp"
+#include "perfCounters.hpp"
+#include "integrity.hpp"
+#include "cpuDispatch.hpp"
+#include "pcgLanes.hpp"
+#include "collatz.hpp"
+#include "primeSieve.hpp"
+#include "millerRabin.hpp"
+#include "sha256.hpp"
+#include "aes.hpp"
 #include <iostream>
 #include <random>
 #include <string>
@@ -16,53 +32,123 @@
 #include <algorithm>
 #include <numeric>
 #include <optional>
+#include <array>
+#include <sstream>
+#include <map>
+#include <cstdlib>
 class esst {
 public:
-    void init() {
+    // Returns the process exit code: non-zero once a run has failed the baseline gate or an SDC check.
+    int init() {
         detect_cpu_features();
+        ResultLog::shared().setMachine(cpu_brand, APP_VERSION);
         std::cout << "ESST version " << APP_VERSION << " | CPU: " << cpu_brand << "\n";
-        std::cout << "Features: AVX" << (has_avx ? "+" : "-")
-                  << " | AVX2" << (has_avx2 ? "+" : "-")
-                  << " | FMA" << (has_fma ? "+" : "-") << "\n";
+        std::cout << "Features: " << cpu.featureSummary() << "\n";
+        std::cout << "Kernels: " << cpu.kernelSummary() << "\n";
+        std::cout << "Topology: " << topology.summary() << " | Placement: " << Topology::name(placement)
+                  << " (" << num_threads << " threads)\n";
+        if (const char* path = std::getenv("ESST_BASELINE"); path && *path) {
+            const char* tolerance = std::getenv("ESST_TOLERANCE");
+            loadBaseline(path, tolerance && *tolerance ? std::atof(tolerance) : DEFAULT_TOLERANCE_PERCENT);
+        }
+        if (const char* mode = std::getenv("ESST_AVX_MODE"); mode && std::string(mode) == "throughput") {
+            avx_mode = CpuDispatch::AvxMode::Throughput;
+            std::cout << "AVX mode: throughput\n";
+        }
+        if (const char* sdc = std::getenv("ESST_SDC"); sdc && std::string(sdc) == "1") {
+            sdc_checks = true;
+            std::cout << "SDC checks: on\n";
+        }
 
         while (running) {
             std::cout << "[ESST] >> ";
             if (!std::getline(std::cin, op_mode)) break;
 
             if (auto it = command_map.find(op_mode); it != command_map.end()) {
+                ResultLog::shared().beginRun(op_mode);
                 it->second();
+                ResultLog::shared().endRun();
             }
             else if (!op_mode.empty()) {
                 std::cout << "Invalid command\n";
             }
         }
+        return ResultLog::shared().failed() ? 1 : 0;
     }
 
 private:
+    // Kernel results a worker compared against the scalar reference.
+    struct SpotCheck {
+        uint64_t checked = 0;
+        uint64_t mismatched = 0;
+    };
+
+    // Per-thread outcome of a timed run.
+    struct RunResult {
+        std::vector<double> scores; // work units per second
+        std::vector<double> mhz;    // average effective clock of each thread's core, 0 if unknown
+        double window = 0;          // seconds
+        FrequencySampler::Source clock_source;
+        std::vector<PerfCounters::Counts> counters; // per thread, over its kernel only
+    };
+
     bool running = true;
     std::string op_mode;
     std::string cpu_brand;
-    bool has_avx = false, has_avx2 = false, has_fma = false;
-    const unsigned int num_threads = std::thread::hardware_concurrency();
+    const CpuDispatch& cpu = CpuDispatch::get(); // kernel variants picked from CPUID, ESST_ISA and ESST_SHA
+    const Topology topology = Topology::detect(); // before the pool pins anything, so it sees the process mask
+    Topology::Placement placement = Topology::Placement::FillSmt;
+    WorkerPool& pool = WorkerPool::shared(); // spawned and pinned once, reused by every command
+    unsigned int num_threads = pool.size();  // one per CPU of the placement, defaults to the allowed set
+    std::map<std::string, std::vector<double>> run_history; // total throughput of every run, per kernel/thread count
+    bool sdc_checks = false; // CPU kernels run their seeded, self-verifying rounds instead of random inputs
+    CpuDispatch::AvxMode avx_mode = CpuDispatch::AvxMode::Latency;
+    CpuDispatch::Sha sha_engine = CpuDispatch::get().sha();
 
     static constexpr auto APP_VERSION = "0.8.5";
     static constexpr int AVX_BUFFER_SIZE = 64; // 256 bytes (L1 cache line optimized)
-    static constexpr int COLLATZ_BATCH_SIZE = 10000000;
+    static constexpr unsigned long COLLATZ_BATCH_SIZE = 4096; // numbers between stop-flag checks
+    static constexpr size_t SHA_STREAMS = 16;                   // buffers hashed per call, one group of the widest lanes
+    static constexpr size_t SHA_STREAM_BYTES = 16 * 1024;       // 256KB per call between stop-flag checks
+    static constexpr std::chrono::milliseconds SHA_COMPARE_TIME{200}; // per engine in the pre-run comparison
+    static constexpr size_t AES_CHUNK_BLOCKS = 4096;            // 64KB between stop-flag checks, one XTS data unit
+    static constexpr std::chrono::milliseconds AES_MEASURE_TIME{100}; // per mode and direction before a run
+    static constexpr size_t AES_GCM_RECORD_BYTES = 16 * 1024;   // a full TLS record
+    static constexpr size_t AES_GCM_AAD_BYTES = 13;             // TLS 1.2 additional data: sequence, type, version, length
+    static constexpr unsigned AES_GCM_RECORDS_PER_KEY = 64;     // records sealed under one key before the next
+    static constexpr unsigned long ROWHAMMER_CHUNK = 1 << 16;   // hammer loops per memory round
+    static constexpr double DEFAULT_TOLERANCE_PERCENT = 5.0;    // baseline gate, overridable by ESST_TOLERANCE
+    static constexpr uint64_t SDC_SEED = 0x5dc5eed;             // inputs of the checked rounds, the same on every core
+    static constexpr unsigned PRIMES_ROUND_NUMBERS = 16;        // numbers factored per checked round
+    static constexpr size_t PRIMES_INPUT_BATCH = 64;            // inputs drawn per refill of primesWorker
+    static constexpr size_t MILLER_RABIN_BATCH = 4096;          // consecutive odd candidates per batch
+    static constexpr unsigned MILLER_RABIN_CHECK_EVERY = 256;   // batches per cross-check against the sieve
+    static constexpr const char* MIX_CPU_KERNELS[] = {"avx", "3np1", "primes", "aesenc", "aesdec", "sha"};
 
     const std::unordered_map<std::string, std::function<void()>> command_map = {
         {"exit", [this]() { running = false; }},
         {"menu", [this]() { showMenu(); }},
         {"avx",  [this]() { initAvx(); }},
         {"3np1", [this]() { init3np1(); }},
+        {"3np1sweep", [this]() { initCollatzSweep(); }},
         {"primes", [this]() { initPrimes(); }},
+        {"sieve", [this]() { initSieve(); }},
+        {"millerrabin", [this]() { initMillerRabin(); }},
         {"disk", [this]() { initDiskWrite(); }},
         {"full", [this]() { nuclearOption(); }},
+        {"mix", [this]() { concurrentOption(); }},
+        {"placement", [this]() { choosePlacement(); }},
+        {"baseline", [this]() { chooseBaseline(); }},
+        {"sdc", [this]() { chooseSdcChecks(); }},
+        {"avxmode", [this]() { chooseAvxMode(); }},
+        {"shaengine", [this]() { chooseShaEngine(); }},
         {"mem", [this]() { initMem(); }},
         {"gpu", [this]() { initGPUStress(); }},
         {"sha", [this]() { initSHA256(); }},
         {"lzma", [this]() { initLZMA(); }},
         {"aesenc", [this]() { initAESENC(); }},
-        {"aesdec", [this]() { initAESDEC(); }}
+        {"aesdec", [this]() { initAESDEC(); }},
+        {"aesgcm", [this]() { initAESGCM(); }}
     };
 
     void detect_cpu_features() {
@@ -82,13 +168,17 @@ private:
         memcpy(brand+40, &ecx, 4); memcpy(brand+44, &edx, 4);
 
         cpu_brand = brand;
+    }
 
-        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
-        has_avx = ecx & bit_AVX;
-        has_fma = ecx & bit_FMA;
-
-        __get_cpuid(7, &eax, &ebx, &ecx, &edx);
-        has_avx2 = ebx & bit_AVX2;
+    // False, after saying why, when no variant of the kernel runs on this CPU.
+    static bool kernelSupported(const std::string& kernel) {
+        const CpuDispatch& cpu = CpuDispatch::get();
+        const bool supported = kernel == "avx" ? cpu.avx(CpuDispatch::AvxMode::Latency).run != nullptr
+                             : kernel == "aesenc" || kernel == "aesdec" ? cpu.aes() != CpuDispatch::Aes::None
+                             : kernel == "aesgcm" ? cpu.gcm() != CpuDispatch::Gcm::None
+                             : true;
+        if (!supported) std::cout << kernel << ": not supported on this CPU (" << cpu.featureSummary() << ")\n";
+        return supported;
     }
 
     static void showMenu() {
@@ -96,17 +186,101 @@ private:
                   << "Extreme System Stability Test\n"
                   << "avx   - AVX/FMA Stress Test\n"
                   << "3np1  - Collatz Conjecture bruteforce\n"
+                  << "3np1sweep - Longest 3n+1 trajectory in a range, exact (ends when the range is done)\n"
                   << "primes  - Prime bruteforce\n"
+                  << "sieve  - Segmented prime sieve counting pi(x), exact (ends when the sieve is done)\n"
+                  << "millerrabin - Batched 64-bit Miller-Rabin primality tests, cross-checked against the sieve\n"
                   << "mem   - Extreme memory testing\n"
-                  << "aesenc   - Vector AES Encrypt stressing\n"
-                  << "aesdec   - Vector AES Decrypt stressing\n"
-                  << "sha   - SHA_NI stressing\n"
+                  << "aesenc   - AES encryption (single-block latency chain, then XTS throughput), known-answer verified\n"
+                  << "aesdec   - AES decryption (single-block latency chain, then XTS throughput), known-answer verified\n"
+                  << "aesgcm   - AES-256-GCM records (CTR + carry-less multiply GHASH), sealed and opened, tag-checked\n"
+                  << "sha   - SHA-256 hashing of real buffers (SHA-NI or multi-buffer AVX), FIPS-verified\n"
                   << "disk   - Disk stressing\n"
                   << "lzma   - CPU compression and decompression using LZMA\n"
                   << "gpu   - GPU stressing with HIP\n"
                   << "full  - Combined Full System Stress\n"
+                  << "mix   - Concurrent CPU/MEM/DISK/LZMA stress on partitioned cores\n"
+                  << "placement - Thread placement policy (core/smt/l3/node)\n"
+                  << "baseline - Compare every following run against a stored results CSV\n"
+                  << "sdc   - Silent-data-corruption checks for the CPU kernels (on/off)\n"
+                  << "avxmode - AVX kernel bound by FMA latency or by FMA throughput (latency/throughput)\n"
+                  << "shaengine - SHA-256 engine of the sha test (shani/avx512/avx2/software)\n"
                   << "exit  - Exit Program\n\n";
     }
+    static std::string formatIPC(const PerfCounters::Counts& counts) {
+        if (counts.ipc() <= 0) return "";
+        std::ostringstream out;
+        out << " | IPC " << std::fixed << std::setprecision(2) << counts.ipc();
+        return out.str();
+    }
+    // Measured instruction rate and miss rates summed over all threads, next to the kernel's own
+    // instruction estimate where its score is one (0 otherwise); or why there are none.
+    void printCounters(const std::vector<PerfCounters::Counts>& counters, const double window, const double estimate,
+                       const std::string& indent = "") const {
+        if (!PerfCounters::available()) {
+            std::cout << indent << "Counters: unavailable, " << PerfCounters::unavailableReason()
+                      << "; rates above are estimated instruction counts\n";
+            return;
+        }
+        PerfCounters::Counts total;
+        total.valid.fill(true);
+        for (const auto& counts : counters) {
+            for (size_t e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+                total.value[e] += counts.value[e];
+                total.valid[e] = total.valid[e] && counts.valid[e];
+            }
+        }
+        const auto flags = std::cout.flags();
+        std::cout << std::fixed << std::setprecision(2);
+        if (total.has(PerfCounters::Instructions)) {
+            const double measured = total.value[PerfCounters::Instructions] / window;
+            std::cout << indent << "Counters: " << formatIPS(measured) << " measured";
+            if (estimate > 0) std::cout << " (estimate " << std::showpos << (estimate / measured - 1.0) * 100.0 << std::noshowpos << "%)";
+            if (total.ipc() > 0) std::cout << " | IPC " << total.ipc();
+            std::cout << "\n";
+        }
+        std::cout << indent << "MPKI:     ";
+        const char* separator = "";
+        for (const auto event : {PerfCounters::L1dMisses, PerfCounters::LlcMisses, PerfCounters::BranchMisses, PerfCounters::DtlbMisses}) {
+            std::cout << separator << PerfCounters::name(event) << " ";
+            if (total.has(event)) std::cout << total.mpki(event);
+            else std::cout << "n/a";
+            separator = " | ";
+        }
+        std::cout << "\n";
+        std::cout.flags(flags);
+    }
+    static std::string formatMHz(const double mhz) {
+        return mhz > 0 ? " @ " + std::to_string(static_cast<int>(mhz)) + " MHz" : "";
+    }
+    // Floating-point operations behind one unit of the avx score, for the selected variant.
+    static double avxFlopsPerUnit(const CpuDispatch::AvxMode mode) {
+        const auto& variant = CpuDispatch::get().avx(mode);
+        return variant.flops / variant.instructions;
+    }
+    // Achieved FLOP/cycle per core (from each thread's effective clock) against the variant's
+    // peak, which only the throughput mode can approach.
+    static void printFlopsPerCycle(const RunResult& result, const double flops_per_unit) {
+        std::vector<double> per_cycle;
+        for (size_t i = 0; i < result.scores.size(); ++i) {
+            if (result.mhz[i] > 0) per_cycle.push_back(result.scores[i] * flops_per_unit / (result.mhz[i] * 1e6));
+        }
+        if (per_cycle.empty()) return;
+        const auto summary = Statistics::summarize(per_cycle);
+        const double peak = CpuDispatch::get().peak_flops_per_cycle;
+        const auto flags = std::cout.flags();
+        std::cout << std::fixed << std::setprecision(2) << "FLOP/cycle: " << summary.mean << " per core (min " << summary.min
+                  << ") of " << std::setprecision(0) << peak << " peak, " << std::setprecision(1) << 100.0 * summary.mean / peak
+                  << "%\n";
+        std::cout.flags(flags);
+    }
+    static std::string formatFLOPS(const double flops) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(2);
+        if (flops >= 1e9) out << flops / 1e9 << " GFLOP/s";
+        else out << flops / 1e6 << " MFLOP/s";
+        return out.str();
+    }
     std::string formatIPS(double flops) const {
         if (flops >= 1e9) {
             return std::to_string(flops / 1e9) + " GIPS";
@@ -119,6 +293,63 @@ private:
         }
         return std::to_string(flops) + " IPS";
     }
+    // Score block shared by the timed commands: per-thread list with outlier cores marked, the
+    // distribution summary, and the run-to-run 95% CI once the same kernel has been repeated
+    // at the same thread count.
+    // Every thread's score is also recorded for the JSON/CSV export.
+    void printScores(const std::string& kernel, const std::string& title, const RunResult& result,
+                     const std::function<std::string(size_t)>& annotate = {}) {
+        const auto& scores = result.scores;
+        const auto summary = Statistics::summarize(scores);
+        const auto outliers = Statistics::outliers(scores);
+        auto& history = run_history[kernel + "/" + std::to_string(scores.size())];
+        history.push_back(summary.total);
+        for (size_t i = 0; i < scores.size(); ++i) {
+            const auto& counts = result.counters[i];
+            ResultLog::shared().record({kernel, static_cast<int>(i), pool.cpu(i), scores[i], unitOf(kernel), result.window, result.mhz[i],
+                                        counts.value[PerfCounters::Instructions] / result.window, counts.ipc()});
+        }
+
+        const auto percent = [](const double fraction) {
+            std::ostringstream out;
+            out << std::showpos << std::fixed << std::setprecision(1) << fraction * 100.0 << "%";
+            return out.str();
+        };
+
+        std::cout << "\n====== " << title << " STRESS SCORE ======\n";
+        for (size_t i = 0; i < scores.size(); ++i) {
+            std::cout << "Thread " << i << " (CPU " << pool.cpu(i) << "): "
+                      << formatIPS(scores[i]) << formatMHz(result.mhz[i]) << formatIPC(result.counters[i]) << (annotate ? annotate(i) : "");
+            if (const auto it = std::ranges::find(outliers, i, &Statistics::Outlier::index); it != outliers.end()) {
+                std::cout << "  <-- OUTLIER " << percent(it->deviation) << " vs median";
+            }
+            std::cout << "\n";
+        }
+        std::cout << "-------------------------------\n";
+        std::cout << "Total:  " << formatIPS(summary.total) << "\n";
+        std::cout << "Avg:    " << formatIPS(summary.mean) << " | Stddev: " << formatIPS(summary.stddev)
+                  << " | CV: " << percent(summary.cv).substr(1) << "\n";
+        std::cout << "p5:     " << formatIPS(summary.p5) << " | Median: " << formatIPS(summary.p50)
+                  << " | p95: " << formatIPS(summary.p95) << "\n";
+        if (const auto clock = Statistics::summarize(result.mhz); clock.max > 0) {
+            std::cout << "Clock:  avg " << static_cast<int>(clock.mean) << " MHz | min " << static_cast<int>(clock.min)
+                      << " | max " << static_cast<int>(clock.max) << " (" << FrequencySampler::name(result.clock_source) << ")\n";
+        }
+        printCounters(result.counters, result.window, unitOf(kernel) == "IPS" ? summary.total : 0.0);
+        if (!outliers.empty()) {
+            std::cout << "Outlier cores:";
+            for (const auto& outlier : outliers) {
+                std::cout << " CPU " << pool.cpu(outlier.index) << " (" << percent(outlier.deviation) << ")";
+            }
+            std::cout << "\n";
+        }
+        if (const auto ci = Statistics::confidence95(history)) {
+            std::cout << "Run-to-run (" << ci->count << " runs): " << formatIPS(ci->mean) << " +/- "
+                      << formatIPS(ci->half_width) << " (95% CI, " << percent(ci->half_width / ci->mean).substr(1) << ")\n";
+        }
+        std::cout << "================================\n";
+    }
+
     static void initGPUStress (std::optional<int> iterations_o = std::nullopt){
         if (!iterations_o.has_value()) {
             std::cout << "Iterations?: ";
@@ -145,10 +376,10 @@ private:
         stop_system_monitor();
     }
 
-    void init3np1(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<unsigned long> lower_o = std::nullopt, std::optional<unsigned long> upper_o = std::nullopt) const {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
+    void init3np1(std::optional<int> duration_o = std::nullopt, std::optional<unsigned long> lower_o = std::nullopt, std::optional<unsigned long> upper_o = std::nullopt) {
+        if (!duration_o.has_value()) {
+            std::cout << "Duration (s)?: ";
+            if (!(std::cin >> duration_o.emplace())) return;
         }
         if (!lower_o.has_value()) {
             std::cout << "Lower bound?: ";
@@ -158,44 +389,148 @@ private:
             std::cout << "Upper bound?: ";
             if (!(std::cin >> upper_o.emplace())) return;
         }
-        const unsigned long iterations = iterations_o.value();
+        const int duration = duration_o.value();
         const unsigned long lower = lower_o.value();
         const unsigned long upper = upper_o.value();
-        if (iterations_o.value() == 0) return;
+        if (duration_o.value() <= 0) return;
         spawn_system_monitor();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
 
-        for (int i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = collatzWorker(iterations, lower, upper, i);
-            });
+        std::vector<SpotCheck> checks(num_threads);
+        const RunResult result = sdc_checks
+            ? runChecked("3np1", duration, [&](const unsigned round, Digest& digest) { return collatzRound(round, digest, lower, upper); })
+            : runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+                  collatzWorker(run, progress, lower, upper, i, &checks[i]);
+              });
+
+        printScores("3np1", "3n+1", result);
+        if (!sdc_checks) {
+            SpotCheck total;
+            for (const auto& check : checks) {
+                total.checked += check.checked;
+                total.mismatched += check.mismatched;
+            }
+            std::cout << "Step counts: " << Collatz::name() << " | " << total.checked << " spot-checked against the scalar reference, "
+                      << total.mismatched << " mismatched\n";
+            if (total.mismatched > 0)
+                ResultLog::shared().fail("3np1: " + std::to_string(total.mismatched) + " step counts differ from the scalar reference");
         }
-        for (auto& t : threads) t.join();
+        stop_system_monitor();
 
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::ranges::sort(scores);
-        const double median = scores[scores.size() / 2];
+    }
 
-        std::cout << "\n====== 3n+1 STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+    // Sweeps [lower, upper] for its longest trajectory, within a time limit. Scores are starts
+    // computed per second; the window closes as soon as the sweep is complete.
+    void initCollatzSweep() {
+        unsigned long lower = 0, upper = 0;
+        int limit = 0;
+        std::cout << "Lower bound?: ";
+        if (!(std::cin >> lower)) return;
+        std::cout << "Upper bound?: ";
+        if (!(std::cin >> upper)) return;
+        std::cout << "Time limit (s)?: ";
+        if (!(std::cin >> limit)) return;
+        if (limit <= 0 || upper < lower) return;
+        spawn_system_monitor();
+
+        CollatzSweep sweep(lower, upper, num_threads);
+        const RunResult result = runTimed(limit, [&](RunControl& run, ProgressCounter& progress, const unsigned i) {
+            sweep.work(i, run, progress);
+        });
+
+        printScores("3np1sweep", "3n+1 sweep", result);
+        const CollatzSweep::Best best = sweep.best();
+        std::cout << "Range: " << sweep.values() << " values | " << sweep.starts() << " trajectories, " << sweep.skipped()
+                  << " skipped (3k+2) | " << (sweep.complete() ? "complete" : "stopped at time limit") << "\n";
+        if (best.witness) {
+            const uint64_t reference = CollatzSweep::referenceSteps(best.witness);
+            std::cout << "Max steps " << best.steps << " at n=" << best.witness << (sweep.complete() ? "" : " (so far)")
+                      << " | reference " << (reference == best.steps ? "agrees" : "DIFFERS: " + std::to_string(reference)) << "\n";
+            if (reference != best.steps)
+                ResultLog::shared().fail("3np1sweep: n=" + std::to_string(best.witness) + " counted " + std::to_string(best.steps)
+                                         + " steps, reference " + std::to_string(reference));
+        }
+        stop_system_monitor();
+    }
+
+    // Counts the primes up to x, within a time limit. Scores are primes found per second; the
+    // window closes as soon as the sieve is complete.
+    void initSieve() {
+        uint64_t limit = 0;
+        int time_limit = 0;
+        std::cout << "Limit x (up to " << PrimeSieve::MAX_LIMIT << ")?: ";
+        if (!(std::cin >> limit)) return;
+        std::cout << "Time limit (s)?: ";
+        if (!(std::cin >> time_limit)) return;
+        if (time_limit <= 0 || limit > PrimeSieve::MAX_LIMIT) return;
+        spawn_system_monitor();
+
+        PrimeSieve sieve(limit, num_threads);
+        const RunResult result = runTimed(time_limit, [&](RunControl& run, ProgressCounter& progress, const unsigned i) {
+            sieve.work(i, run, progress);
+        });
+
+        printScores("sieve", "SIEVE", result);
+        std::cout << "Sieve: " << sieve.segments() << " segments of " << sieve.segmentBytes() / 1024 << "KB (mod-30 wheel) | "
+                  << (sieve.complete() ? "complete" : "stopped at time limit") << "\n";
+        if (sieve.complete()) {
+            const uint64_t count = sieve.count();
+            const std::optional<uint64_t> known = PrimeSieve::knownCount(limit);
+            std::cout << "pi(" << limit << ") = " << count;
+            if (known) std::cout << " | known value " << (*known == count ? "agrees" : "DIFFERS: " + std::to_string(*known));
+            std::cout << "\n";
+            if (known && *known != count)
+                ResultLog::shared().fail("sieve: pi(" + std::to_string(limit) + ") counted " + std::to_string(count) + ", known "
+                                         + std::to_string(*known));
+        } else {
+            std::cout << "Primes found so far: " << sieve.count() << "\n";
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "================================\n";
         stop_system_monitor();
+    }
+
+    // Tests blocks of consecutive odd candidates starting at random points of [lower, upper]. Scores
+    // are tests per second. One batch in MILLER_RABIN_CHECK_EVERY is compared against the sieve's
+    // primality of the same range, if it lies within the sieve's limit.
+    void initMillerRabin() {
+        int duration = 0;
+        uint64_t lower = 0, upper = 0;
+        std::cout << "Duration (s)?: ";
+        if (!(std::cin >> duration)) return;
+        std::cout << "Lower bound?: ";
+        if (!(std::cin >> lower)) return;
+        std::cout << "Upper bound?: ";
+        if (!(std::cin >> upper)) return;
+        if (duration <= 0 || upper < lower) return;
+        upper = std::min(upper, UINT64_MAX - 2 * MILLER_RABIN_BATCH);
+        lower = std::min(lower, upper);
+        spawn_system_monitor();
 
+        const uint64_t highest = std::min(upper + 2 * MILLER_RABIN_BATCH, PrimeSieve::MAX_LIMIT);
+        const std::optional<PrimeSieve> sieve = lower + 2 * MILLER_RABIN_BATCH <= highest
+            ? std::optional<PrimeSieve>(std::in_place, highest, 1)
+            : std::nullopt;
+        std::vector<SpotCheck> checks(num_threads);
+        const RunResult result = runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+            millerRabinWorker(run, progress, lower, upper, i, sieve ? &*sieve : nullptr, &checks[i]);
+        });
+
+        printScores("millerrabin", "MILLER-RABIN", result);
+        SpotCheck total;
+        for (const auto& check : checks) {
+            total.checked += check.checked;
+            total.mismatched += check.mismatched;
+        }
+        std::cout << "Primality: " << MillerRabin::name() << " | ";
+        if (sieve) std::cout << total.checked << " candidates cross-checked against the sieve, " << total.mismatched << " mismatched\n";
+        else std::cout << "not cross-checked, candidates above the sieve limit " << PrimeSieve::MAX_LIMIT << "\n";
+        if (total.mismatched > 0)
+            ResultLog::shared().fail("millerrabin: " + std::to_string(total.mismatched) + " primality results differ from the sieve");
+        stop_system_monitor();
     }
 
-    void initPrimes(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<float> lower_o = std::nullopt, std::optional<float> upper_o = std::nullopt) const {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
+    void initPrimes(std::optional<int> duration_o = std::nullopt, std::optional<float> lower_o = std::nullopt, std::optional<float> upper_o = std::nullopt) {
+        if (!duration_o.has_value()) {
+            std::cout << "Duration (s)?: ";
+            if (!(std::cin >> duration_o.emplace())) return;
         }
         if (!lower_o.has_value()) {
             std::cout << "Lower bound?: ";
@@ -205,44 +540,27 @@ private:
             std::cout << "Upper bound?: ";
             if (!(std::cin >> upper_o.emplace())) return;
         }
-        const unsigned long iterations = iterations_o.value();
+        const int duration = duration_o.value();
         const unsigned long lower = lower_o.value();
         const unsigned long upper = upper_o.value();
-        if (iterations_o.value() == 0) return;
+        if (duration_o.value() <= 0) return;
         spawn_system_monitor();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = primesWorker(iterations, lower, upper, i);
-            });
-        }
-        for (auto& t : threads) t.join();
 
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::ranges::sort(scores);
-        const double median = scores[scores.size() / 2];
+        const RunResult result = sdc_checks
+            ? runChecked("primes", duration, [&](const unsigned round, Digest& digest) { return primesRound(round, digest, lower, upper); })
+            : runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+                  primesWorker(run, progress, lower, upper, i);
+              });
 
-        std::cout << "\n====== PRIMES STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
-        }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "==================================\n";
+        printScores("primes", "PRIMES", result);
         stop_system_monitor();
         
     }
 
-    void initAvx(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<float> lower_o = std::nullopt, std::optional<float> upper_o = std::nullopt) const {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
+    void initAvx(std::optional<int> duration_o = std::nullopt, std::optional<float> lower_o = std::nullopt, std::optional<float> upper_o = std::nullopt) {
+        if (!duration_o.has_value()) {
+            std::cout << "Duration (s)?: ";
+            if (!(std::cin >> duration_o.emplace())) return;
         }
         if (!lower_o.has_value()) {
             std::cout << "Lower bound?: ";
@@ -252,41 +570,33 @@ private:
             std::cout << "Upper bound?: ";
             if (!(std::cin >> upper_o.emplace())) return;
         }
-        const unsigned long iterations = iterations_o.value();
+        const int duration = duration_o.value();
         const unsigned long lower = lower_o.value();
         const unsigned long upper = upper_o.value();
-        if (iterations_o.value() == 0) return;
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
+        if (duration_o.value() <= 0 || !kernelSupported("avx")) return;
+        // The modes score different instruction mixes, so they keep separate histories and baselines
+        const auto mode = avx_mode;
+        const std::string kernel = mode == CpuDispatch::AvxMode::Throughput ? "avx-throughput" : "avx";
         spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = avxWorker(iterations, lower, upper, i);
-            });
-        }
-        for (auto& t : threads) t.join();
-
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        double median = scores[scores.size() / 2];
-
-        std::cout << "\n====== AVX STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
-        }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "===============================\n";
+        const RunResult result = sdc_checks
+            ? runChecked(kernel, duration, [&](const unsigned round, Digest& digest) { return avxRound(round, digest, lower, upper, mode); })
+            : runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+                  avxWorker(run, progress, lower, upper, i, mode);
+              });
+
+        const double flops_per_unit = avxFlopsPerUnit(mode);
+        printScores(kernel, mode == CpuDispatch::AvxMode::Throughput ? "AVX THROUGHPUT" : "AVX", result,
+                    [&](const size_t i) { return " | " + formatFLOPS(result.scores[i] * flops_per_unit); });
+        std::cout << "FLOP/s: " << formatFLOPS(Statistics::summarize(result.scores).total * flops_per_unit) << " total ("
+                  << CpuDispatch::name(cpu.vector()) << ", " << CpuDispatch::name(mode) << "-bound)\n";
+        printFlopsPerCycle(result, flops_per_unit);
         stop_system_monitor();
         
     }
 
 
-    void initMem(std::optional<unsigned long> user_iterations = std::nullopt) const {
+    // node_o: -1 binds each thread's buffer to its own node, >= 0 puts every buffer on that node.
+    void initMem(std::optional<int> duration_o = std::nullopt, std::optional<int> node_o = std::nullopt) {
         char status;
         std::cout << "ONE TIME WARNING, THIS TEST CONTAINS ROWHAMMER ATTACK, PROCEED? (yY/nN): ";
         std::cin >> status;
@@ -294,190 +604,203 @@ private:
         case 'y': case 'Y': break;
         default: return;
         }
-        if (!user_iterations.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> user_iterations.emplace())) return;
-        }
-        if (user_iterations.value() == 0) return;
-        const unsigned long iterations = user_iterations.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = memoryWorker(iterations, i);
-            });
+        if (!duration_o.has_value()) {
+            std::cout << "Duration (s)?: ";
+            if (!(std::cin >> duration_o.emplace())) return;
         }
-        for (auto& t : threads) t.join();
+        if (duration_o.value() <= 0) return;
+        const int duration = duration_o.value();
 
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        const double median = scores[scores.size() / 2];
+        const auto nodes = topology.nodes();
+        if (!node_o.has_value() && nodes.size() > 1) {
+            std::string mode;
+            std::cout << "NUMA placement local/remote?: ";
+            if (!(std::cin >> mode)) return;
+            node_o = -1;
+            if (mode == "remote") {
+                std::cout << "Remote node?: ";
+                if (!(std::cin >> node_o.value())) return;
+            }
+        }
+        const int remote_node = node_o.value_or(-1);
+        if (remote_node >= 0 && std::ranges::find(nodes, remote_node) == nodes.end()) {
+            std::cout << "No allowed CPUs on node " << remote_node << "\n";
+            return;
+        }
 
-        std::cout << "\n====== MEM STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+        spawn_system_monitor();
+        std::vector<MemoryTraffic> traffic(num_threads);
+        const RunResult result = runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+            const int node = remote_node >= 0 ? remote_node : topology.nodeOf(pool.cpu(i));
+            memoryWorker(run, progress, i, node, &traffic[i]);
+        });
+
+        printScores("mem", "MEM", result, [&](const size_t i) {
+            return " | CPU node " + std::to_string(topology.nodeOf(pool.cpu(i))) + " -> memory node " + std::to_string(traffic[i].node);
+        });
+
+        // Bandwidth is attributed to the node that actually backs each buffer
+        std::cout << "------ MEM BANDWIDTH PER NODE ------\n";
+        struct NodeTraffic {
+            double bytes = 0;
+            unsigned local = 0, remote = 0; // threads on / off the node
+        };
+        std::map<int, NodeTraffic> per_node;
+        for (size_t i = 0; i < traffic.size(); ++i) {
+            auto& node = per_node[traffic[i].node];
+            node.bytes += traffic[i].bytes;
+            ++(traffic[i].node == topology.nodeOf(pool.cpu(i)) ? node.local : node.remote);
+        }
+        for (const auto& [node, stats] : per_node) {
+            ResultLog::shared().record({"mem-node" + std::to_string(node), -1, -1, stats.bytes / result.window, "B/s", result.window});
+            std::cout << "Node " << (node < 0 ? std::string("?") : std::to_string(node)) << ": "
+                      << std::fixed << std::setprecision(2) << stats.bytes / result.window / 1e9 << " GB/s ("
+                      << stats.local << " local, " << stats.remote << " remote threads)\n";
+            std::cout.unsetf(std::ios::floatfield);
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
         std::cout << "=================================\n";
         stop_system_monitor();
         
     }
 
-    void initAESENC(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<unsigned long> blksize_o = std::nullopt) const {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
+    void initAESENC(std::optional<int> duration_o = std::nullopt, std::optional<unsigned long> blksize_o = std::nullopt) {
+        initAES(Aes::Direction::Encrypt, duration_o, blksize_o);
+    }
+
+    void initAESDEC(std::optional<int> duration_o = std::nullopt, std::optional<unsigned long> blksize_o = std::nullopt) {
+        initAES(Aes::Direction::Decrypt, duration_o, blksize_o);
+    }
+
+    void initAES(const Aes::Direction direction, std::optional<int> duration_o, std::optional<unsigned long> blksize_o) {
+        const bool encrypt = direction == Aes::Direction::Encrypt;
+        const std::string kernel = encrypt ? "aesenc" : "aesdec";
+        if (!duration_o.has_value()) {
+            std::cout << "Duration (s)?: ";
+            if (!(std::cin >> duration_o.emplace())) return;
         }
         if (!blksize_o.has_value()) {
             std::cout << "Blocksize?: ";
             if (!(std::cin >> blksize_o.emplace())) return;
         }
-        if (iterations_o.value() == 0) return;
-        unsigned long iterations = iterations_o.value();
+        if (duration_o.value() <= 0 || !kernelSupported(kernel)) return;
+        const int duration = duration_o.value();
         unsigned int block_size = blksize_o.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
+        if (!aesSelfTest(kernel)) return;
+        measureAesModes();
         spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = aesENCWorker(iterations, i, block_size);
-            });
-        }
-        for (auto& t : threads) t.join();
-
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        const double median = scores[scores.size() / 2];
-
-        std::cout << "\n====== AESENC STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
-        }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "==================================\n";
+        const RunResult result = sdc_checks
+            ? runChecked(kernel, duration, [&](const unsigned round, Digest& digest) { return aesRound(round, digest, direction); })
+            : runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned) {
+                  aesWorker(run, progress, block_size, direction);
+              });
+
+        printScores(kernel, encrypt ? "AESENC" : "AESDEC", result);
+        const double bytes = std::accumulate(result.scores.begin(), result.scores.end(), 0.0);
+        std::cout << "Throughput: " << std::fixed << std::setprecision(2) << bytes / 1e9 << " GB/s total ("
+                  << (encrypt ? "encrypt, " : "decrypt, ") << CpuDispatch::name(cpu.aes()) << ")\n";
+        std::cout.unsetf(std::ios::floatfield);
         stop_system_monitor();
         
     }
 
-    void initAESDEC(std::optional<unsigned long> iterations_o = std::nullopt, std::optional<unsigned long> blksize_o = std::nullopt) {
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
+    // Known answers first: a run of a cipher that is not AES would only measure its speed
+    static bool aesSelfTest(const std::string& kernel) {
+        std::string failure;
+        if (!Aes::selfTest(failure)) {
+            std::cout << "AES self-test failed: " << failure << "\n";
+            ResultLog::shared().fail(kernel + ": " + failure);
+            return false;
         }
-        if (!blksize_o.has_value()) {
-            std::cout << "Blocksize?: ";
-            if (!(std::cin >> blksize_o.emplace())) return;
+        std::cout << "AES self-test: FIPS 197, SP 800-38A, IEEE 1619 and GCM vectors match\n";
+        return true;
+    }
+
+    // Every thread seals TLS-sized records with AES-256-GCM and opens them again; a record that
+    // does not come back with its tag and plaintext is a wrong result of the CPU. Scores are
+    // bytes through the cipher, both directions counted.
+    void initAESGCM(std::optional<int> duration_o = std::nullopt) {
+        if (!duration_o.has_value()) {
+            std::cout << "Duration (s)?: ";
+            if (!(std::cin >> duration_o.emplace())) return;
         }
-        if (iterations_o.value() == 0) return;
-        spawn_system_monitor();
-        unsigned long iterations = iterations_o.value();
-        unsigned int block_size = blksize_o.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
+        const int duration = duration_o.value();
+        if (duration <= 0 || !kernelSupported("aesgcm") || !aesSelfTest("aesgcm")) return;
+        const CpuDispatch::Gcm engine = cpu.gcm();
+        measureGcmEngines();
         spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = aesDECWorker(iterations, i, block_size);
-            });
-        }
-        for (auto& t : threads) t.join();
 
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        const double median = scores[scores.size() / 2];
-
-        std::cout << "\n====== AESDEC STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+        std::vector<SpotCheck> checks(num_threads);
+        const RunResult result = sdc_checks
+            ? runChecked("aesgcm", duration, [&](const unsigned round, Digest& digest) { return aesGcmRound(round, digest, engine); })
+            : runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+                  aesGcmWorker(run, progress, engine, checks[i]);
+              });
+
+        printScores("aesgcm", "AES-GCM", result);
+        const double bytes = std::accumulate(result.scores.begin(), result.scores.end(), 0.0);
+        std::cout << "Throughput: " << std::fixed << std::setprecision(2) << bytes / 1e9 << " GB/s total (seal and open, "
+                  << CpuDispatch::name(engine) << ")\n";
+        std::cout.unsetf(std::ios::floatfield);
+        if (!sdc_checks) {
+            SpotCheck total;
+            for (const auto& check : checks) {
+                total.checked += check.checked;
+                total.mismatched += check.mismatched;
+            }
+            std::cout << "Records: " << total.checked << " opened, " << total.mismatched << " without their tag or plaintext\n";
+            if (total.mismatched > 0)
+                ResultLog::shared().fail("aesgcm: " + std::to_string(total.mismatched) + " records did not open to their plaintext");
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "==================================\n";
         stop_system_monitor();
-        
     }
 
-    void initDiskWrite(std::optional<unsigned long> iterations_o = std::nullopt){
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
+    void initDiskWrite(std::optional<int> duration_o = std::nullopt){
+        if (!duration_o.has_value()) {
+            std::cout << "Duration (s)?: ";
+            if (!(std::cin >> duration_o.emplace())) return;
         }
-        unsigned long iterations = iterations_o.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
+        const int duration = duration_o.value();
         spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = diskWriteWorker(iterations, i);
-            });
-        }
-        for (auto& t : threads) t.join();
+        const RunResult result = runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+            diskWriteWorker(run, progress, i);
+        });
 
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::sort(scores.begin(), scores.end());
-        const double median = scores[scores.size() / 2];
-
-        std::cout << "\n====== DISK STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
-        }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "================================\n";
+        printScores("disk", "DISK", result);
         stop_system_monitor();
         
     }
 
-    void initSHA256(std::optional<unsigned long> iterations_o = std::nullopt){
-        if (!iterations_o.has_value()) {
-            std::cout << "Iterations?: ";
-            if (!(std::cin >> iterations_o.emplace())) return;
-        }
-        const unsigned long iterations = iterations_o.value();
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-        std::vector<double> scores(num_threads);
-        spawn_system_monitor();
-        for (unsigned i = 0; i < num_threads; ++i) {
-            threads.emplace_back([=, &scores]() {
-                scores[i] = sha256Worker(iterations, i);
-            });
+    void initSHA256(std::optional<int> duration_o = std::nullopt){
+        if (!duration_o.has_value()) {
+            std::cout << "Duration (s)?: ";
+            if (!(std::cin >> duration_o.emplace())) return;
         }
-        for (auto& t : threads) t.join();
-
-        const double total = std::accumulate(scores.begin(), scores.end(), 0.0);
-        const double avg   = total / scores.size();
-        std::ranges::sort(scores);
-        const double median = scores[scores.size() / 2];
-
-        std::cout << "\n====== SHA STRESS SCORE ======\n";
-        for (size_t i = 0; i < scores.size(); ++i) {
-            std::cout << "Thread " << i << ": "
-                      << formatIPS(scores[i]) << "\n";
+        const int duration = duration_o.value();
+        if (duration <= 0) return;
+        // Known answers first: a run on an engine that hashes wrong would only measure its speed
+        const auto engine = sha_engine;
+        std::string failure;
+        const bool passed = Sha256::selfTest(engine, failure);
+        if (passed) std::cout << "SHA-256 self-test: " << CpuDispatch::name(engine) << " matches the FIPS 180-2 vectors\n";
+        if (!passed || !compareShaEngines(failure)) {
+            std::cout << "SHA-256 self-test failed: " << failure << "\n";
+            ResultLog::shared().fail("sha: " + failure);
+            return;
         }
-        std::cout << "-------------------------------\n";
-        std::cout << "Avg:    " << formatIPS(avg) << "\n";
-        std::cout << "Median: " << formatIPS(median) << "\n";
-        std::cout << "================================\n";
+        // Engines other than the one picked for this CPU keep separate histories and baselines
+        const std::string kernel = engine == cpu.sha() ? "sha" : std::string("sha-") + CpuDispatch::option(engine);
+        spawn_system_monitor();
+        const RunResult result = sdc_checks
+            ? runChecked(kernel, duration, [&](const unsigned round, Digest& digest) { return shaRound(round, digest, engine); })
+            : runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+                  sha256Worker(run, progress, i, engine);
+              });
+
+        printScores(kernel, "SHA", result);
+        const double bytes = std::accumulate(result.scores.begin(), result.scores.end(), 0.0);
+        std::cout << "Throughput: " << std::fixed << std::setprecision(2) << bytes / 1e9 << " GB/s total ("
+                  << CpuDispatch::name(engine) << ")\n";
+        std::cout.unsetf(std::ios::floatfield);
         stop_system_monitor();
         
     }
@@ -487,29 +810,24 @@ private:
         std::cout << "Intensity (1 = default): ";
         std::cin >> intensity;
         std::cout << "Launching full stress test...\n";
-        unsigned long nuke_iterations_avx = 2000000 * intensity;
-        unsigned long nuke_iterations_3np1 = 20000000 * intensity;
-        unsigned long nuke_iterations_primes = 1 * intensity;
-        unsigned long nuke_iterations_aes = 20 * intensity;
-        unsigned long nuke_iterations_disk = 20 * intensity;
-        unsigned long nuke_iterations_mem = 20 * intensity;
-        unsigned long nuke_iterations_gpu = 5000 * intensity;
-        unsigned long nuke_iterations_sha = 100000000 * intensity;
-        unsigned long nuke_duration_lzma = 60 * intensity;
-        constexpr unsigned long lower_avx = 0.0001, upper_avx = 1000000000000000;
+        const int nuke_duration = 30 * intensity;   // seconds per phase
+        const int nuke_iterations_gpu = 5000 * intensity;
+        const int nuke_duration_lzma = 60 * intensity;
+        constexpr float lower_avx = 0.0001, upper_avx = 1000000000000000;
         constexpr unsigned long lower = 1, upper = 1000000000000000;
         constexpr int block_size = 24;
         const auto start = std::chrono::high_resolution_clock::now();
         spawn_system_monitor();
-        initMem(nuke_iterations_mem);
-        initAvx(nuke_iterations_avx, lower_avx, upper_avx);
-        init3np1(nuke_iterations_3np1, lower, upper);
-        initPrimes(nuke_iterations_primes, lower, upper);
-        initAESENC(nuke_iterations_aes, block_size);
-        initAESDEC(nuke_iterations_aes, block_size);
-        initDiskWrite(nuke_iterations_disk);
+        initMem(nuke_duration, -1);
+        initAvx(nuke_duration, lower_avx, upper_avx);
+        init3np1(nuke_duration, lower, upper);
+        initPrimes(nuke_duration, lower, upper);
+        initAESENC(nuke_duration, block_size);
+        initAESDEC(nuke_duration, block_size);
+        initAESGCM(nuke_duration);
+        initDiskWrite(nuke_duration);
         initGPUStress(nuke_iterations_gpu);
-        initSHA256(nuke_iterations_sha);
+        initSHA256(nuke_duration);
         initLZMA(nuke_duration_lzma);
         const auto duration = std::chrono::high_resolution_clock::now() - start;
         std::cout << "Full test complete! Time: "
@@ -518,19 +836,480 @@ private:
         stop_system_monitor();
     }
 
-    static void pinThread(int core) {
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        CPU_SET(core % std::thread::hardware_concurrency(), &cpuset);
-        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    // Unit of the per-thread scores each kernel reports, for the export.
+    static std::string unitOf(const std::string& kernel) {
+        if (kernel == "disk") return "B/s";
+        if (kernel == "mem") return "rounds/s";
+        if (kernel == "primes" || kernel == "3np1") return "numbers/s";
+        if (kernel == "3np1sweep") return "starts/s";
+        if (kernel == "sieve") return "primes/s";
+        if (kernel == "millerrabin") return "tests/s";
+        if (kernel.starts_with("aes") || kernel.starts_with("sha")) return "B/s";
+        return "IPS";
+    }
+
+    void chooseBaseline() {
+        std::string path;
+        double tolerance = 0;
+        std::cout << "Baseline CSV?: ";
+        if (!(std::cin >> path)) return;
+        std::cout << "Tolerance (%)?: ";
+        if (!(std::cin >> tolerance) || tolerance <= 0) return;
+        loadBaseline(path, tolerance);
+    }
+
+    static void loadBaseline(const std::string& path, const double tolerance_percent) {
+        if (ResultLog::shared().loadBaseline(path, tolerance_percent / 100.0)) {
+            std::cout << "Baseline: " << path << " (+/-" << tolerance_percent << "%), checked after every run\n";
+        }
+    }
+
+    void chooseAvxMode() {
+        std::string mode;
+        std::cout << "AVX mode latency/throughput?: ";
+        if (!(std::cin >> mode) || (mode != "latency" && mode != "throughput")) return;
+        avx_mode = mode == "throughput" ? CpuDispatch::AvxMode::Throughput : CpuDispatch::AvxMode::Latency;
+        std::cout << "AVX mode: " << mode << "\n";
+    }
+
+    void chooseShaEngine() {
+        std::string name;
+        std::cout << "SHA-256 engine shani/avx512/avx2/software?: ";
+        if (!(std::cin >> name)) return;
+        for (const auto engine : {CpuDispatch::Sha::ShaNi, CpuDispatch::Sha::Avx512, CpuDispatch::Sha::Avx2, CpuDispatch::Sha::Software}) {
+            if (name != CpuDispatch::option(engine)) continue;
+            if (!cpu.supports(engine)) {
+                std::cout << "SHA-256 engine " << CpuDispatch::name(engine) << ": not supported on this CPU (" << cpu.featureSummary() << ")\n";
+                return;
+            }
+            sha_engine = engine;
+            std::cout << "SHA-256 engine: " << CpuDispatch::name(engine) << "\n";
+        }
+    }
+
+    // Hashes the same seeded buffers on every engine this CPU runs, for a moment each on this
+    // thread: the digests must be identical, and the rates show what each engine is worth here.
+    static bool compareShaEngines(std::string& failure) {
+        const CpuDispatch& cpu = CpuDispatch::get();
+        PcgLanes gen(SDC_SEED, 0);
+        std::vector<uint8_t> buffer(SHA_STREAMS * SHA_STREAM_BYTES);
+        gen.fillBytes(buffer.data(), buffer.size());
+        const uint8_t* streams[SHA_STREAMS];
+        for (size_t i = 0; i < SHA_STREAMS; ++i) streams[i] = buffer.data() + i * SHA_STREAM_BYTES;
+        Sha256::Digest reference[SHA_STREAMS];
+        Sha256::hash(CpuDispatch::Sha::Software, streams, SHA_STREAM_BYTES, reference, SHA_STREAMS);
+
+        std::cout << "SHA-256 engines:";
+        for (const auto engine : {CpuDispatch::Sha::ShaNi, CpuDispatch::Sha::Avx512, CpuDispatch::Sha::Avx2, CpuDispatch::Sha::Software}) {
+            if (!cpu.supports(engine)) continue;
+            Sha256::Digest digests[SHA_STREAMS];
+            unsigned calls = 0;
+            const auto start = std::chrono::steady_clock::now();
+            std::chrono::duration<double> elapsed{};
+            do {
+                Sha256::hash(engine, streams, SHA_STREAM_BYTES, digests, SHA_STREAMS);
+                ++calls;
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while (elapsed < SHA_COMPARE_TIME);
+            if (!std::equal(digests, digests + SHA_STREAMS, reference)) {
+                std::cout << "\n";
+                failure = std::string(CpuDispatch::name(engine)) + ": digests differ from the portable engine";
+                return false;
+            }
+            std::cout << " " << CpuDispatch::name(engine) << " " << std::fixed << std::setprecision(2)
+                      << calls * buffer.size() / elapsed.count() / 1e9 << " GB/s |";
+            std::cout.unsetf(std::ios::floatfield);
+        }
+        std::cout << " digests identical\n";
+        return true;
+    }
+
+    // GB/s of pass() over bytes, repeated on this thread for AES_MEASURE_TIME
+    template <typename Pass> static double gigabytesPerSecond(const size_t bytes, const Pass& pass) {
+        unsigned passes = 0;
+        const auto start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed{};
+        do {
+            pass();
+            ++passes;
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while (elapsed < AES_MEASURE_TIME);
+        return passes * bytes / elapsed.count() / 1e9;
+    }
+
+    // Each mode on one AES-256 buffer for a moment on this thread, in both directions and on every
+    // engine this CPU runs: the xmm pipeline next to the VAES ones shows what the wider registers
+    // buy, and what the XTS pass of the run is worth next to ECB and CTR. The AES-128 blocks of
+    // the chain, one after the other and independent, bound the latency half of the run.
+    static void measureAesModes() {
+        const CpuDispatch& cpu = CpuDispatch::get();
+        PcgLanes gen(SDC_SEED, 0);
+        std::vector<uint8_t> buffer(AES_CHUNK_BLOCKS * Aes::BLOCK);
+        uint8_t key_bytes[64];
+        gen.fillBytes(buffer.data(), buffer.size());
+        gen.fillBytes(key_bytes, sizeof(key_bytes));
+        const Aes::Key key = Aes::expand(key_bytes, 32), tweak_key = Aes::expand(key_bytes + 32, 32);
+        uint8_t* data = buffer.data();
+        const auto rate = [&](const auto& pass) { return gigabytesPerSecond(buffer.size(), pass); };
+        const auto ecb = [&](const Aes::Direction direction) {
+            return rate([&] { Aes::ecb(key, direction, data, data, AES_CHUNK_BLOCKS); });
+        };
+        const auto xts = [&](const Aes::Engine engine, const Aes::Direction direction) {
+            return rate([&] { Aes::xts(engine, key, tweak_key, direction, 0, data, data, AES_CHUNK_BLOCKS); });
+        };
+        const auto ctr = [&](const Aes::Engine engine) {
+            uint8_t counter[Aes::BLOCK] = {};
+            return rate([&] { Aes::ctr(engine, key, counter, data, data, AES_CHUNK_BLOCKS); });
+        };
+        const Aes::Key chain_key = Aes::expand(key_bytes, 16);
+        const auto single = [&](const Aes::BlockMode mode, const Aes::Direction direction) {
+            return rate([&] { Aes::blocks(chain_key, direction, mode, data, data, AES_CHUNK_BLOCKS); });
+        };
+        std::cout << std::fixed << std::setprecision(2) << "AES-128 single blocks GB/s on one thread, encrypt/decrypt: chain "
+                  << single(Aes::BlockMode::Chain, Aes::Direction::Encrypt) << "/" << single(Aes::BlockMode::Chain, Aes::Direction::Decrypt)
+                  << " | independent " << single(Aes::BlockMode::Independent, Aes::Direction::Encrypt) << "/"
+                  << single(Aes::BlockMode::Independent, Aes::Direction::Decrypt) << "\n";
+        std::cout << "AES-256 GB/s on one thread, encrypt/decrypt: ECB "
+                  << ecb(Aes::Direction::Encrypt) << "/" << ecb(Aes::Direction::Decrypt) << " (AES-NI)\n";
+        for (const auto engine : {CpuDispatch::Aes::AesNiVex, CpuDispatch::Aes::Vaes256, CpuDispatch::Aes::Vaes512}) {
+            if (!cpu.supports(engine)) continue;
+            std::cout << "  " << std::left << std::setw(14) << CpuDispatch::name(engine) << std::right << " CTR " << ctr(engine)
+                      << " | XTS " << xts(engine, Aes::Direction::Encrypt) << "/" << xts(engine, Aes::Direction::Decrypt)
+                      << (engine == cpu.aes() ? "  <- run" : "") << "\n";
+        }
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    // Sealing and opening one record on every AES-GCM engine this CPU runs: PCLMULQDQ next to the
+    // VPCLMULQDQ ones shows what the wider carry-less multiplies buy.
+    static void measureGcmEngines() {
+        const CpuDispatch& cpu = CpuDispatch::get();
+        PcgLanes gen(SDC_SEED, 0);
+        std::vector<uint8_t> record(AES_GCM_RECORD_BYTES);
+        uint8_t key_bytes[32], aad[AES_GCM_AAD_BYTES], iv[Aes::GCM_IV_BYTES], tag[Aes::BLOCK];
+        gen.fillBytes(record.data(), record.size());
+        gen.fillBytes(key_bytes, sizeof(key_bytes));
+        gen.fillBytes(aad, sizeof(aad));
+        gen.fillBytes(iv, sizeof(iv));
+        const Aes::GcmKey key = Aes::gcmExpand(key_bytes, sizeof(key_bytes));
+        uint8_t* data = record.data();
+        std::cout << std::fixed << std::setprecision(2) << "AES-256-GCM GB/s on one thread, seal/open of "
+                  << AES_GCM_RECORD_BYTES / 1024 << "KB records:\n";
+        for (const auto engine : {CpuDispatch::Gcm::Pclmul, CpuDispatch::Gcm::Vpclmul256, CpuDispatch::Gcm::Vpclmul512}) {
+            if (!cpu.supports(engine)) continue;
+            const double seal = gigabytesPerSecond(record.size(), [&] {
+                Aes::gcmEncrypt(engine, key, iv, aad, sizeof(aad), data, data, record.size(), tag);
+            });
+            const double open = gigabytesPerSecond(record.size(), [&] {
+                Aes::gcmDecrypt(engine, key, iv, aad, sizeof(aad), data, data, record.size(), tag);
+            });
+            std::cout << "  " << std::left << std::setw(20) << CpuDispatch::name(engine) << std::right << " " << seal << "/" << open
+                      << (engine == cpu.gcm() ? "  <- run" : "") << "\n";
+        }
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    void chooseSdcChecks() {
+        std::string mode;
+        std::cout << "SDC checks on/off?: ";
+        if (!(std::cin >> mode) || (mode != "on" && mode != "off")) return;
+        sdc_checks = mode == "on";
+        std::cout << "SDC checks: " << mode << (sdc_checks ? " (avx, 3np1, primes, aesenc, aesdec, aesgcm, sha)" : "") << "\n";
+    }
+
+    // Re-pins the pool to the chosen policy; every later launch uses its CPU order and thread count.
+    void choosePlacement() {
+        std::string name;
+        std::cout << "Placement core (physical cores) / smt (fill SMT) / l3 (spread L3) / node (pack NUMA node)?: ";
+        if (!(std::cin >> name)) return;
+        const auto policy = Topology::parsePlacement(name);
+        if (!policy) {
+            std::cout << "Invalid placement\n";
+            return;
+        }
+
+        int node = -1;
+        if (*policy == Topology::Placement::PackNode && topology.nodes().size() > 1) {
+            std::cout << "NUMA node?: ";
+            if (!(std::cin >> node)) return;
+            if (const auto nodes = topology.nodes(); std::ranges::find(nodes, node) == nodes.end()) {
+                std::cout << "No allowed CPUs on node " << node << "\n";
+                return;
+            }
+        }
+
+        placement = *policy;
+        pool.reset(topology.place(placement, node));
+        num_threads = pool.size();
+        std::cout << "Placement: " << Topology::name(placement) << " | " << num_threads << " threads on CPUs";
+        for (unsigned i = 0; i < num_threads; ++i) std::cout << (i ? "," : " ") << pool.cpu(i);
+        std::cout << "\n";
+    }
+
+    // Runs every kernel class at the same time on its own slice of cores, so power delivery and
+    // the memory fabric see the combined worst case instead of one subsystem per phase.
+    void concurrentOption() const {
+        int duration = 0;
+        std::cout << "Duration (s)?: ";
+        if (!(std::cin >> duration) || duration <= 0) return;
+
+        std::string split;
+        std::cout << "Core split cpu:mem:disk:lzma (e.g. 4:2:1:1, 0 disables a class)?: ";
+        if (!(std::cin >> split)) return;
+        const auto cores = partitionCores(split);
+        if (!cores) {
+            std::cout << "Invalid core split\n";
+            return;
+        }
+        const auto [cpu_cores, mem_cores, disk_cores, lzma_cores] = *cores;
+
+        if (mem_cores > 0) {
+            char status;
+            std::cout << "ONE TIME WARNING, THIS TEST CONTAINS ROWHAMMER ATTACK, PROCEED? (yY/nN): ";
+            std::cin >> status;
+            switch (status) {
+            case 'y': case 'Y': break;
+            default: return;
+            }
+        }
+
+        struct Slot {
+            std::string kernel;
+            unsigned core;
+        };
+        std::vector<std::string> cpu_kernels; // the rotation, less kernels this CPU cannot run
+        for (const char* kernel : MIX_CPU_KERNELS)
+            if (kernelSupported(kernel)) cpu_kernels.emplace_back(kernel);
+        std::vector<Slot> slots;
+        unsigned core = 0;
+        for (unsigned i = 0; i < cpu_cores; ++i, ++core)
+            slots.push_back({cpu_kernels[i % cpu_kernels.size()], core});
+        for (unsigned i = 0; i < mem_cores; ++i, ++core) slots.push_back({"mem", core});
+        for (unsigned i = 0; i < disk_cores; ++i, ++core) slots.push_back({"disk", core});
+        const unsigned lzma_first_core = core;
+
+        std::cout << "Launching concurrent stress: " << cpu_cores << " CPU, " << mem_cores << " MEM, "
+                  << disk_cores << " DISK, " << lzma_cores << " LZMA cores for " << duration << " s...\n";
+        spawn_system_monitor();
+        RunControl run{std::chrono::seconds(duration), static_cast<unsigned>(slots.size())};
+        std::vector<ProgressCounter> progress(slots.size());
+        std::vector<std::string> labels;
+        for (const auto& slot : slots) labels.push_back(slot.kernel + "@" + std::to_string(pool.cpu(slot.core)));
+        ProgressSampler sampler(progress, std::move(labels), [this](const double v) { return formatIPS(v); });
+        std::vector<int> cpus;
+        for (const auto& slot : slots) cpus.push_back(pool.cpu(slot.core));
+        FrequencySampler clocks(std::move(cpus));
+        std::vector<PerfCounters::Counts> counters(slots.size());
+
+        WorkerPool::Group group;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            pool.submit(group, slots[i].core, [&, i]() {
+                PerfCounters perf;
+                run.arriveAndWait();
+                perf.start();
+                runMixKernel(slots[i].kernel, run, progress[i], slots[i].core, avx_mode, sha_engine);
+                counters[i] = perf.stop();
+                run.finished();
+                clocks.measureHere(i);
+            });
+        }
+        run.start();
+        sampler.start(run.startTime());
+        clocks.start();
+        // LZMA keeps its own one-second progress clock; started together it covers the same window.
+        const double lzma_bytes_per_sec = lzma_cores > 0 ? startLZMAPartition(duration, lzma_cores, lzma_first_core) : 0.0;
+        run.waitAndStop();
+        clocks.stop();
+        group.wait();
+        sampler.stop(run.window());
+        sampler.report(std::cout);
+
+        std::cout << "\n====== CONCURRENT STRESS SCORE ======\n";
+        std::vector<std::pair<std::string, std::vector<size_t>>> per_kernel; // kernel -> slot indices
+        const std::vector<double> scores = sampler.rates();
+        const std::vector<double> mhz = clocks.mhz();
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const auto& slot = slots[i];
+            ResultLog::shared().record({slot.kernel, static_cast<int>(i), pool.cpu(slot.core), scores[i], unitOf(slot.kernel), run.window(), mhz[i],
+                                        counters[i].value[PerfCounters::Instructions] / run.window(), counters[i].ipc()});
+            std::cout << "Core " << pool.cpu(slot.core) << " [" << slot.kernel << "]: " << formatIPS(scores[i]) << formatMHz(mhz[i])
+                      << formatIPC(counters[i]) << "\n";
+            auto it = std::ranges::find(per_kernel, slot.kernel, &std::pair<std::string, std::vector<size_t>>::first);
+            if (it == per_kernel.end()) it = per_kernel.insert(per_kernel.end(), {slot.kernel, {}});
+            it->second.push_back(i);
+        }
+        std::cout << "-------------------------------\n";
+        for (const auto& [kernel, members] : per_kernel) {
+            // Outliers are judged against the cores running the same kernel
+            std::vector<double> peers, peer_mhz;
+            std::vector<PerfCounters::Counts> peer_counters;
+            for (const size_t i : members) {
+                peers.push_back(scores[i]);
+                peer_mhz.push_back(mhz[i]);
+                peer_counters.push_back(counters[i]);
+            }
+            const auto summary = Statistics::summarize(peers);
+            std::cout << std::left << std::setw(8) << kernel << std::right
+                      << "Total: " << formatIPS(summary.total)
+                      << " | Per thread: " << formatIPS(summary.mean)
+                      << " | CV: " << std::fixed << std::setprecision(1) << summary.cv * 100.0 << "%"
+                      << formatMHz(Statistics::summarize(peer_mhz).mean)
+                      << " (" << peers.size() << " threads)\n";
+            if (PerfCounters::available()) {
+                printCounters(peer_counters, run.window(), unitOf(kernel) == "IPS" ? summary.total : 0.0, "        ");
+            }
+            for (const auto& outlier : Statistics::outliers(peers)) {
+                std::cout << "        Outlier: CPU " << pool.cpu(slots[members[outlier.index]].core) << " "
+                          << std::showpos << outlier.deviation * 100.0 << std::noshowpos << "% vs median\n";
+            }
+            std::cout.unsetf(std::ios::floatfield);
+        }
+        if (lzma_cores > 0) {
+            std::cout << std::left << std::setw(8) << "lzma" << std::right
+                      << "Total: " << std::fixed << std::setprecision(1) << lzma_bytes_per_sec / (1024.0 * 1024.0)
+                      << " MB/s (" << lzma_cores << " threads)\n";
+            std::cout.unsetf(std::ios::floatfield);
+        }
+        std::cout << "Clock source: " << FrequencySampler::name(clocks.source()) << "\n";
+        if (!PerfCounters::available()) std::cout << "Counters: unavailable, " << PerfCounters::unavailableReason() << "\n";
+        std::cout << "Window: " << run.window() << " s | Slowest stop: " << run.overrunMs() << " ms past deadline\n";
+        std::cout << "======================================\n";
+        stop_system_monitor();
+    }
+
+    // Splits num_threads cores between the cpu:mem:disk:lzma classes proportionally to the given weights.
+    std::optional<std::array<unsigned, 4>> partitionCores(const std::string& split) const {
+        std::array<unsigned, 4> weights{};
+        std::istringstream in(split);
+        for (size_t i = 0; i < weights.size(); ++i) {
+            if (!(in >> weights[i])) return std::nullopt;
+            if (i + 1 < weights.size() && in.get() != ':') return std::nullopt;
+        }
+        const unsigned weight_sum = std::accumulate(weights.begin(), weights.end(), 0u);
+        const auto enabled = std::ranges::count_if(weights, [](unsigned w) { return w > 0; });
+        if (weight_sum == 0 || num_threads < static_cast<unsigned>(enabled)) return std::nullopt;
+
+        // Every enabled class gets one core, the rest is handed out by largest remainder.
+        std::array<unsigned, 4> cores{};
+        std::array<double, 4> remainder{};
+        const unsigned spare = num_threads - enabled;
+        unsigned assigned = 0;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            if (weights[i] == 0) continue;
+            const double share = static_cast<double>(spare) * weights[i] / weight_sum;
+            cores[i] = 1 + static_cast<unsigned>(share);
+            remainder[i] = share - static_cast<unsigned>(share);
+            assigned += cores[i];
+        }
+        while (assigned < num_threads) {
+            const auto best = std::ranges::max_element(remainder) - remainder.begin();
+            ++cores[best];
+            remainder[best] = -1.0;
+            ++assigned;
+        }
+        return cores;
+    }
+
+    // Runs one kernel of the concurrent mode until the shared stop, publishing into progress.
+    static void runMixKernel(const std::string& kernel, const RunControl& run, ProgressCounter& progress, const unsigned core,
+                             const CpuDispatch::AvxMode avx_mode, const CpuDispatch::Sha sha_engine) {
+        constexpr unsigned long lower = 1, upper = 1000000000000000;
+        if (kernel == "avx") avxWorker(run, progress, 0.0001f, 1e15f, core, avx_mode);
+        else if (kernel == "3np1") collatzWorker(run, progress, lower, upper, core);
+        else if (kernel == "primes") primesWorker(run, progress, lower, upper, core);
+        else if (kernel == "aesenc") aesENCWorker(run, progress, core, 16);
+        else if (kernel == "aesdec") aesDECWorker(run, progress, core, 16);
+        else if (kernel == "sha") sha256Worker(run, progress, core, sha_engine);
+        else if (kernel == "mem") memoryWorker(run, progress, core);
+        else if (kernel == "disk") diskWriteWorker(run, progress, core);
+    }
+
+    // Runs worker(run, progress[i], i) on every pool worker until the deadline. All workers start
+    // behind the run's barrier and publish their work units as they go; a sampler turns the
+    // counters into the live display and the timeline, and the result is each thread's
+    // throughput over the one shared window, with the effective clock its core ran at and the
+    // hardware counters of its kernel.
+    template <typename Worker>
+    RunResult runTimed(const int duration, Worker&& worker) const {
+        std::vector<ProgressCounter> progress(num_threads);
+        RunControl run{std::chrono::seconds(duration), num_threads};
+        std::vector<std::string> labels;
+        for (unsigned i = 0; i < num_threads; ++i) labels.push_back("T" + std::to_string(i));
+        ProgressSampler sampler(progress, std::move(labels), [this](const double v) { return formatIPS(v); });
+        std::vector<int> cpus;
+        for (unsigned i = 0; i < num_threads; ++i) cpus.push_back(pool.cpu(i));
+        FrequencySampler clocks(std::move(cpus));
+        std::vector<PerfCounters::Counts> counters(num_threads);
+
+        WorkerPool::Group group;
+        for (unsigned i = 0; i < num_threads; ++i) {
+            pool.submit(group, i, [&, i] {
+                PerfCounters perf;
+                run.arriveAndWait();
+                perf.start();
+                worker(run, progress[i], i);
+                counters[i] = perf.stop();
+                run.finished();
+                clocks.measureHere(i);
+            });
+        }
+        run.start();
+        sampler.start(run.startTime());
+        clocks.start();
+        run.waitAndStop();
+        clocks.stop();
+        group.wait();
+        sampler.stop(run.window());
+
+        std::cout << "\nWindow: " << run.window() << " s | Slowest stop: " << run.overrunMs() << " ms past deadline\n";
+        sampler.report(std::cout);
+        return {sampler.rates(), clocks.mhz(), run.window(), clocks.source(), std::move(counters)};
     }
+
+    // Checked counterpart of runTimed: round(r, digest) performs seeded round r, folds everything it
+    // produced into digest and returns its work units. The reference digests are taken on worker 0
+    // while the others idle; then every worker cycles through the rounds and verifies each one.
+    template <typename Round>
+    RunResult runChecked(const std::string& kernel, const int duration, Round&& round) const {
+        IntegrityCheck check(kernel, num_threads, pool.cpu(0));
+        std::cout << "SDC: computing " << IntegrityCheck::ROUNDS << " reference digests on CPU " << pool.cpu(0) << "\n";
+        pool.parallel(1, [&](unsigned) {
+            for (unsigned r = 0; r < IntegrityCheck::ROUNDS; ++r) {
+                Digest digest;
+                round(r, digest);
+                check.setReference(r, digest.value());
+            }
+        });
+
+        RunResult result = runTimed(duration, [&](const RunControl& run, ProgressCounter& progress, const unsigned i) {
+            for (uint64_t iteration = 0; !run.stopped(); ++iteration) {
+                Digest digest;
+                progress.add(round(iteration % IntegrityCheck::ROUNDS, digest));
+                check.verify(i, iteration, digest.value());
+            }
+        });
+
+        std::vector<int> cpus;
+        for (unsigned i = 0; i < num_threads; ++i) cpus.push_back(pool.cpu(i));
+        if (!check.report(std::cout, cpus)) {
+            ResultLog::shared().fail(kernel + ": " + std::to_string(check.mismatches()) + " corrupted rounds");
+        }
+        return result;
+    }
+
     static void* allocate_huge_buffer(size_t size) {
     #ifdef __linux__
         void* ptr = mmap(nullptr, size, PROT_READ|PROT_WRITE,
                         MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
         if (ptr != MAP_FAILED) return ptr;
-    #endif
+        // No reserved huge pages: plain mapping backed by THP, so free_buffer's munmap still matches
+        ptr = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) return nullptr;
+        madvise(ptr, size, MADV_HUGEPAGE);
+        return ptr;
+    #else
         return aligned_alloc(1 << 21, size); // Fallback to 2MB aligned
+    #endif
     }
 
     static void free_buffer(void* buf, size_t size) {
@@ -541,9 +1320,21 @@ private:
     #endif
     }
 
-    static double memoryWorker(unsigned long iterations, const int thread_id) {
-        pinThread(thread_id);
-        const auto start = std::chrono::high_resolution_clock::now();
+    struct MemoryTraffic {
+        int node = -1;    // node backing the buffer after the run, as reported by the kernel
+        double bytes = 0; // estimated cache-line traffic of the completed passes
+    };
+
+    // Cache lines each flood kernel touches per pass, as a fraction of the buffer size, and the
+    // lines one rowhammer loop pulls back from DRAM after its clflushes.
+    static constexpr double FLOOD_L1L2_LINES = 1.0;   // 3 lines per 192-byte step
+    static constexpr double FLOOD_MEMORY_LINES = 1.75; // burst 1/4 + rmw 1/2 + mixed 1
+    static constexpr double FLOOD_NT_LINES = 1.55;     // stream 1/4 + interleaved 4/5 + reverse 1/2
+    static constexpr double ROWHAMMER_BYTES = 7 * 64;
+
+    // node >= 0 binds the buffer to that node before first touch; -1 leaves it to first-touch
+    // from this (pinned) thread. traffic, if given, receives the node and bytes moved.
+    static void memoryWorker(const RunControl& run, ProgressCounter& progress, const int thread_id, const int node = -1, MemoryTraffic* traffic = nullptr) {
         constexpr size_t size = 1 << 30; // 1GB
         constexpr size_t buffer_size = size;
 
@@ -551,189 +1342,286 @@ private:
         void* buffer = allocate_huge_buffer(size);
         if (!buffer) {
             std::cerr << "Failed to allocate memory buffer for thread " << thread_id << std::endl;
-            return 0.0;
+            return;
+        }
+        if (node >= 0 && !Topology::bindMemory(buffer, size, node)) {
+            std::cerr << "Thread " << thread_id << ": could not bind buffer to node " << node << ", using first-touch\n";
         }
 
-        // Run the stress tests
-        for (unsigned long i = 0; i < iterations; ++i) {
-            floodL1L2(buffer, &iterations, buffer_size);
-            floodMemory(buffer, &iterations, buffer_size);
-            floodNt(buffer, &iterations, buffer_size);
-            rowhammerAttack(buffer, &iterations, buffer_size);
+        // One pass of every pattern per round; the kernels poll the stop flag inside their sweeps
+        unsigned long passes = 1;
+        unsigned long hammer_passes = ROWHAMMER_CHUNK;
+        double bytes = 0;
+        while (!run.stopped()) {
+            const unsigned long l1l2 = floodL1L2(buffer, &passes, buffer_size, run.flag());
+            const unsigned long memory = floodMemory(buffer, &passes, buffer_size, run.flag());
+            const unsigned long nt = floodNt(buffer, &passes, buffer_size, run.flag());
+            const unsigned long hammer = rowhammerAttack(buffer, &hammer_passes, buffer_size, run.flag());
+            progress.add((l1l2 + memory + nt + (hammer == hammer_passes)) / 4.0);
+            bytes += (l1l2 * FLOOD_L1L2_LINES + memory * FLOOD_MEMORY_LINES + nt * FLOOD_NT_LINES) * buffer_size
+                   + hammer * ROWHAMMER_BYTES;
+        }
+        if (traffic) {
+            traffic->node = Topology::memoryNode(buffer);
+            traffic->bytes = bytes;
         }
         free_buffer(buffer, size);
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
+    }
 
+    // Hashes SHA_STREAMS random buffers per call; each digest is written back over the start of its
+    // buffer, so every call hashes new data.
+    static void sha256Worker(const RunControl& run, ProgressCounter& progress, const int tid, const CpuDispatch::Sha engine) {
+        PcgLanes gen(42u + tid, 54u + tid);
+        std::vector<uint8_t> buffer(SHA_STREAMS * SHA_STREAM_BYTES);
+        gen.fillBytes(buffer.data(), buffer.size());
+        const uint8_t* streams[SHA_STREAMS];
+        for (size_t i = 0; i < SHA_STREAMS; ++i) streams[i] = buffer.data() + i * SHA_STREAM_BYTES;
+        Sha256::Digest digests[SHA_STREAMS];
+
+        while (!run.stopped()) {
+            Sha256::hash(engine, streams, SHA_STREAM_BYTES, digests, SHA_STREAMS);
+            for (size_t i = 0; i < SHA_STREAMS; ++i) std::memcpy(buffer.data() + i * SHA_STREAM_BYTES, digests[i].data(), digests[i].size());
+            progress.add(static_cast<double>(buffer.size()));
+        }
     }
 
-    static double sha256Worker(unsigned long iterations, const int thread_id) {
-        pinThread(thread_id);
-        const auto start = std::chrono::high_resolution_clock::now();
-        sha256(iterations);
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
+    static void aesENCWorker(const RunControl& run, ProgressCounter& progress, int, const int block_size) {
+        aesWorker(run, progress, block_size, Aes::Direction::Encrypt);
+    }
 
+    static void aesDECWorker(const RunControl& run, ProgressCounter& progress, int, const int block_size) {
+        aesWorker(run, progress, block_size, Aes::Direction::Decrypt);
     }
 
-    static double aesENCWorker(const long iterations, int tid, const int block_size) {
-        pinThread(tid);
-        const auto start = std::chrono::high_resolution_clock::now();
-        // Allocate aligned buffers
-        alignas(16) uint8_t key[32] = {0x01}; // All-zero key (worst-case)
-        alignas(16) uint8_t expanded_key[240]; // AES-256 expanded key
-        alignas(16) uint8_t plaintext[16] = {0};
-        alignas(16) uint8_t ciphertext[16];
-        const size_t BLOCKS = 1 << block_size;
-        auto buffer = std::make_unique<uint8_t[]>(BLOCKS * 16);
-        pcg32 gen(std::random_device{}());
-        std::uniform_int_distribution<uint8_t> dist(0, 255);
-        for (auto& v : key) v = dist(gen);
-        for (long i = 0; i < iterations; i++){
-            // Key expansion (stress FPU)
-            aes256Keygen(expanded_key);
-            // Encrypt individual blocks (stress latency)
-            for (size_t i = 0; i < BLOCKS; i++) {
-                aes128EncryptBlock(ciphertext, plaintext, key);
-                asm volatile("" : : "r"(ciphertext) : "memory");
+    // Fresh keys every pass (key expansion), then 1 << block_size single AES-128 blocks, each
+    // output the next input, in batches that hold the round keys in registers (latency), then
+    // XTS-AES-256 over as many blocks on the widest AES engine (throughput). progress counts bytes.
+    static void aesWorker(const RunControl& run, ProgressCounter& progress, const int block_size, const Aes::Direction direction) {
+        const Aes::Engine engine = CpuDispatch::get().aes();
+        const size_t BLOCKS = size_t{1} << block_size;
+        auto buffer = std::make_unique<uint8_t[]>(BLOCKS * Aes::BLOCK);
+        PcgLanes gen(std::random_device{}(), std::random_device{}());
+        gen.fillBytes(buffer.get(), BLOCKS * Aes::BLOCK);
+        std::vector<uint8_t> chain(AES_CHUNK_BLOCKS * Aes::BLOCK);
+        alignas(16) uint8_t key_bytes[16 + 32 + 32];
+        alignas(16) uint8_t block[Aes::BLOCK] = {0};
+        uint64_t unit = 0;
+        while (!run.stopped()) {
+            gen.fillBytes(key_bytes, sizeof(key_bytes));
+            const Aes::Key chain_key = Aes::expand(key_bytes, 16);
+            const Aes::Key data_key = Aes::expand(key_bytes + 16, 32), tweak_key = Aes::expand(key_bytes + 48, 32);
+            for (size_t i = 0; i < BLOCKS && !run.stopped(); i += AES_CHUNK_BLOCKS) {
+                const size_t chunk = std::min(AES_CHUNK_BLOCKS, BLOCKS - i);
+                Aes::blocks(chain_key, direction, Aes::BlockMode::Chain, block, chain.data(), chunk);
+                std::memcpy(block, chain.data() + (chunk - 1) * Aes::BLOCK, Aes::BLOCK);
+                progress.add(static_cast<double>(chunk * Aes::BLOCK));
+            }
+            for (size_t i = 0; i < BLOCKS && !run.stopped(); i += AES_CHUNK_BLOCKS) {
+                const size_t chunk = std::min(AES_CHUNK_BLOCKS, BLOCKS - i);
+                uint8_t* data = buffer.get() + i * Aes::BLOCK;
+                Aes::xts(engine, data_key, tweak_key, direction, unit++, data, data, chunk);
+                progress.add(static_cast<double>(chunk * Aes::BLOCK));
             }
-            // XTS mode (stress throughput)
-            uint8_t tweak[16] = {0};
-            aesXtsEncrypt(buffer.get(), buffer.get(), expanded_key, tweak, BLOCKS);
         }
+    }
 
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
+    // AES-256-GCM records under a fresh key every AES_GCM_RECORDS_PER_KEY, the sequence number as
+    // nonce: each record is sealed, then opened again and compared, and its ciphertext is the next
+    // record. progress counts the bytes of both directions.
+    static void aesGcmWorker(const RunControl& run, ProgressCounter& progress, const CpuDispatch::Gcm engine, SpotCheck& check) {
+        PcgLanes gen(std::random_device{}(), std::random_device{}());
+        std::vector<uint8_t> record(AES_GCM_RECORD_BYTES), sealed(AES_GCM_RECORD_BYTES), opened(AES_GCM_RECORD_BYTES);
+        uint8_t key_bytes[32], aad[AES_GCM_AAD_BYTES], iv[Aes::GCM_IV_BYTES] = {}, tag[Aes::BLOCK];
+        gen.fillBytes(record.data(), record.size());
+        uint64_t sequence = 0;
+        while (!run.stopped()) {
+            gen.fillBytes(key_bytes, sizeof(key_bytes));
+            gen.fillBytes(aad, sizeof(aad));
+            const Aes::GcmKey key = Aes::gcmExpand(key_bytes, sizeof(key_bytes));
+            for (unsigned r = 0; r < AES_GCM_RECORDS_PER_KEY && !run.stopped(); ++r, ++sequence) {
+                std::memcpy(iv + Aes::GCM_IV_BYTES - sizeof(sequence), &sequence, sizeof(sequence));
+                Aes::gcmEncrypt(engine, key, iv, aad, sizeof(aad), record.data(), sealed.data(), record.size(), tag);
+                const bool authentic = Aes::gcmDecrypt(engine, key, iv, aad, sizeof(aad), sealed.data(), opened.data(), record.size(), tag);
+                ++check.checked;
+                if (!authentic || opened != record) ++check.mismatched;
+                record.swap(sealed);
+                progress.add(2.0 * AES_GCM_RECORD_BYTES);
+            }
+        }
     }
 
-    static double aesDECWorker(const long iterations, int tid, const int block_size) {
-        pinThread(tid);
-        const auto start = std::chrono::high_resolution_clock::now();
-        // Allocate aligned buffers
-        alignas(16) uint8_t key[32] = {0x01}; // All-zero key (worst-case)
-        alignas(16) uint8_t expanded_key[240]; // AES-256 expanded key
-        alignas(16) uint8_t ciphertext[16] = {0};
-        alignas(16) uint8_t plaintext[16];
-        const size_t BLOCKS = 1 << block_size;
-        auto buffer = std::make_unique<uint8_t[]>(BLOCKS * 16);
-        pcg32 gen(std::random_device{}());
-        std::uniform_int_distribution<uint8_t> dist(0, 255);
-        for (auto& v : key) v = dist(gen);
-
-        for (long i = 0; i < iterations; i++){
-            // Key expansion (stress FPU)
-            aes256Keygen(expanded_key);
-            // Decrypt individual blocks (stress latency)
-            for (size_t i = 0; i < BLOCKS; i++) {
-                aes128DecryptBlock(plaintext, ciphertext, key);
-                asm volatile("" : : "r"(plaintext) : "memory");
+    // Each batch also recomputes one of its numbers with the scalar reference when check is given.
+    static void collatzWorker(const RunControl& run, ProgressCounter& progress, unsigned long lower, unsigned long upper, int tid,
+                              SpotCheck* check = nullptr) {
+        PcgLanes gen(42u + tid, 54u + tid);
+        std::vector<uint64_t> inputs(COLLATZ_BATCH_SIZE), steps(COLLATZ_BATCH_SIZE);
+
+        for (uint64_t batch = 0; !run.stopped(); ++batch) {
+            gen.fillUniform(inputs.data(), inputs.size(), lower, upper);
+            Collatz::batch(inputs.data(), steps.data(), inputs.size());
+            if (check) {
+                const size_t j = batch * 2654435761u % COLLATZ_BATCH_SIZE; // walks every lane position
+                ++check->checked;
+                if (steps[j] != Collatz::steps(inputs[j])) ++check->mismatched;
             }
-            // XTS mode decryption (stress throughput)
-            uint8_t tweak[16] = {0};
-            aesXtsDecrypt(buffer.get(), buffer.get(), expanded_key, tweak, BLOCKS);
+            progress.add(COLLATZ_BATCH_SIZE);
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();
     }
 
-    static double collatzWorker(unsigned long iterations, unsigned long lower, unsigned long upper, int tid) {
-        pinThread(tid);
-        const long instruction_per_threads = 23 * iterations;
-        pcg32 gen(42u + tid, 54u + tid);
-        std::uniform_int_distribution<unsigned long> dist(lower, upper);
+    static void primesWorker(const RunControl& run, ProgressCounter& progress, unsigned long lower, unsigned long upper, int tid) {
+        PcgLanes gen(42u + tid, 54u + tid);
+        uint64_t inputs[PRIMES_INPUT_BATCH];
 
         unsigned long total_steps = 0;
-        const auto start = std::chrono::high_resolution_clock::now();
-
-        for (unsigned long i = 0; i < iterations; ) {
-            const unsigned long batch = std::min(static_cast<unsigned long>(COLLATZ_BATCH_SIZE), iterations - i);
-            unsigned long batch_steps = 0;
-
-            for (unsigned long j = 0; j < batch; ++j) {
+        while (!run.stopped()) {
+            gen.fillUniform(inputs, PRIMES_INPUT_BATCH, lower, upper);
+            for (size_t j = 0; j < PRIMES_INPUT_BATCH && !run.stopped(); ++j) {
                 unsigned long steps = 0;
-                p3np1E(dist(gen), &steps);
-                batch_steps += steps;
+                primes(inputs[j], &steps);
+                total_steps += steps;
+                progress.add(1);
             }
+        }
+    }
 
-            total_steps += batch_steps;
-            i += batch;
+    static void millerRabinWorker(const RunControl& run, ProgressCounter& progress, const uint64_t lower, const uint64_t upper,
+                                  const int tid, const PrimeSieve* sieve, SpotCheck* check) {
+        PcgLanes gen(42u + tid, 54u + tid);
+        std::vector<uint64_t> candidates(MILLER_RABIN_BATCH);
+        std::vector<uint8_t> prime(MILLER_RABIN_BATCH), reference(2 * MILLER_RABIN_BATCH);
+
+        for (uint64_t batch = 0; !run.stopped(); ++batch) {
+            uint64_t first = 0;
+            gen.fillUniform(&first, 1, lower, upper);
+            first |= 1;
+            for (size_t j = 0; j < MILLER_RABIN_BATCH; ++j) candidates[j] = first + 2 * j;
+            MillerRabin::batch(candidates.data(), prime.data(), MILLER_RABIN_BATCH);
+            if (sieve && batch % MILLER_RABIN_CHECK_EVERY == 0 && first + reference.size() - 1 <= sieve->limit()) {
+                sieve->primality(first, reference.size(), reference.data());
+                for (size_t j = 0; j < MILLER_RABIN_BATCH; ++j)
+                    if (prime[j] != reference[2 * j]) ++check->mismatched;
+                check->checked += MILLER_RABIN_BATCH;
+            }
+            progress.add(MILLER_RABIN_BATCH);
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return instruction_per_threads / elapsed.count();  // it/s
     }
 
-    static double primesWorker(unsigned long iterations, unsigned long lower, unsigned long upper, int tid) {
-        pinThread(tid);
-        pcg32 gen(42u + tid, 54u + tid);
-        std::uniform_int_distribution<unsigned long> dist(lower, upper);
+    static void avxWorker(const RunControl& run, ProgressCounter& progress, const float lower, const float upper, int tid,
+                          const CpuDispatch::AvxMode mode = CpuDispatch::AvxMode::Latency) {
+        PcgLanes gen(42u + tid, 54u + tid);
 
-        unsigned long total_steps = 0;
-        const auto start = std::chrono::high_resolution_clock::now();
+        const auto& variant = CpuDispatch::get().avx(mode);
+        alignas(64) float n1[AVX_BUFFER_SIZE], n2[AVX_BUFFER_SIZE], n3[AVX_BUFFER_SIZE];
 
-        for (unsigned long i = 0; i < iterations; ) {
-            const unsigned long batch = std::min(static_cast<unsigned long>(COLLATZ_BATCH_SIZE), iterations - i);
-            unsigned long batch_steps = 0;
+        while (!run.stopped()) {
+            gen.fillUniform(n1, AVX_BUFFER_SIZE, lower, upper);
+            gen.fillUniform(n2, AVX_BUFFER_SIZE, lower, upper);
+            gen.fillUniform(n3, AVX_BUFFER_SIZE, lower, upper);
 
-            for (unsigned long j = 0; j < batch; ++j) {
-                unsigned long steps = 0;
-                primes(dist(gen), &steps);
-                batch_steps += steps;
+            for (unsigned offset = 0; offset < AVX_BUFFER_SIZE; offset += variant.floats) {
+                variant.run(n1+offset, n2+offset, n3+offset);
             }
-
-            total_steps += batch_steps;
-            i += batch;
+            progress.add(variant.instructions * (AVX_BUFFER_SIZE / variant.floats));
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return iterations / elapsed.count();  // it/s
+    }
+    // Checked rounds: the inputs depend only on the round, so every core must reproduce the
+    // reference digest bit for bit. Each returns the work units of its kernel's normal worker.
+    static double collatzRound(const unsigned round, Digest& digest, const unsigned long lower, const unsigned long upper) {
+        PcgLanes gen(SDC_SEED, round);
+        std::vector<uint64_t> inputs(COLLATZ_BATCH_SIZE), steps(COLLATZ_BATCH_SIZE);
+        gen.fillUniform(inputs.data(), inputs.size(), lower, upper);
+        Collatz::batch(inputs.data(), steps.data(), inputs.size());
+        digest.add(steps.data(), steps.size() * sizeof(uint64_t));
+        return COLLATZ_BATCH_SIZE;
     }
 
-    static double avxWorker(const unsigned long iterations, const float lower, const float upper, int tid) {
-        pinThread(tid);
-        const long instruction_per_threads =  999448 * iterations;
-        pcg32 gen(42u + tid, 54u + tid);
-        std::uniform_real_distribution<float> dist(lower, upper);
-
-        alignas(32) float n1[AVX_BUFFER_SIZE], n2[AVX_BUFFER_SIZE], n3[AVX_BUFFER_SIZE];
+    static double primesRound(const unsigned round, Digest& digest, const unsigned long lower, const unsigned long upper) {
+        PcgLanes gen(SDC_SEED, round);
+        uint64_t inputs[PRIMES_ROUND_NUMBERS];
+        gen.fillUniform(inputs, PRIMES_ROUND_NUMBERS, lower, upper);
+        for (const uint64_t n : inputs) {
+            unsigned long steps = 0;
+            primes(n, &steps);
+            digest.add(steps);
+        }
+        return PRIMES_ROUND_NUMBERS;
+    }
 
-        const auto start = std::chrono::high_resolution_clock::now();
+    static double avxRound(const unsigned round, Digest& digest, const float lower, const float upper, const CpuDispatch::AvxMode mode) {
+        PcgLanes gen(SDC_SEED, round);
+        const auto& variant = CpuDispatch::get().avx(mode);
+        alignas(64) float n1[AVX_BUFFER_SIZE], n2[AVX_BUFFER_SIZE], n3[AVX_BUFFER_SIZE];
+        gen.fillUniform(n1, AVX_BUFFER_SIZE, lower, upper);
+        gen.fillUniform(n2, AVX_BUFFER_SIZE, lower, upper);
+        gen.fillUniform(n3, AVX_BUFFER_SIZE, lower, upper);
+        for (unsigned offset = 0; offset < AVX_BUFFER_SIZE; offset += variant.floats) {
+            variant.run(n1 + offset, n2 + offset, n3 + offset);
+        }
+        digest.add(n1, sizeof(n1));
+        return variant.instructions * (AVX_BUFFER_SIZE / variant.floats);
+    }
 
-        for (unsigned long i = 0; i < iterations; ++i) {
-            for (int j = 0; j < AVX_BUFFER_SIZE; ++j) {
-                n1[j] = dist(gen);
-                n2[j] = dist(gen);
-                n3[j] = dist(gen);
-            }
+    static double shaRound(const unsigned round, Digest& digest, const CpuDispatch::Sha engine) {
+        PcgLanes gen(SDC_SEED, round);
+        std::vector<uint8_t> buffer(SHA_STREAMS * SHA_STREAM_BYTES);
+        gen.fillBytes(buffer.data(), buffer.size());
+        const uint8_t* streams[SHA_STREAMS];
+        for (size_t i = 0; i < SHA_STREAMS; ++i) streams[i] = buffer.data() + i * SHA_STREAM_BYTES;
+        Sha256::Digest digests[SHA_STREAMS];
+        Sha256::hash(engine, streams, SHA_STREAM_BYTES, digests, SHA_STREAMS);
+        digest.add(digests, sizeof(digests));
+        return static_cast<double>(buffer.size());
+    }
 
-            for (int offset = 0; offset < AVX_BUFFER_SIZE; offset += 8) {
-                avx(n1+offset, n2+offset, n3+offset);
-            }
+    // A chain of single blocks (each output is the next input), then one XTS pass over a buffer,
+    // with keys expanded from seeded bytes so the digest depends on nothing but the round.
+    static double aesRound(const unsigned round, Digest& digest, const Aes::Direction direction) {
+        PcgLanes gen(SDC_SEED, round);
+        alignas(16) uint8_t key_bytes[16 + 32 + 32];
+        alignas(16) uint8_t block[Aes::BLOCK];
+        std::vector<uint8_t> buffer(AES_CHUNK_BLOCKS * Aes::BLOCK), chain(AES_CHUNK_BLOCKS * Aes::BLOCK);
+        gen.fillBytes(key_bytes, sizeof(key_bytes));
+        gen.fillBytes(block, sizeof(block));
+        gen.fillBytes(buffer.data(), buffer.size());
+        const Aes::Key chain_key = Aes::expand(key_bytes, 16);
+        const Aes::Key data_key = Aes::expand(key_bytes + 16, 32), tweak_key = Aes::expand(key_bytes + 48, 32);
+
+        Aes::blocks(chain_key, direction, Aes::BlockMode::Chain, block, chain.data(), AES_CHUNK_BLOCKS);
+        std::memcpy(block, chain.data() + (AES_CHUNK_BLOCKS - 1) * Aes::BLOCK, Aes::BLOCK);
+        Aes::xts(CpuDispatch::get().aes(), data_key, tweak_key, direction, round, buffer.data(), buffer.data(), AES_CHUNK_BLOCKS);
+        digest.add(block, sizeof(block));
+        digest.add(buffer.data(), buffer.size());
+        return 2.0 * AES_CHUNK_BLOCKS * Aes::BLOCK;
+    }
 
-        }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        return instruction_per_threads / elapsed.count();
+    // One seeded record sealed and opened again; the digest takes the ciphertext, the tag and what
+    // came out of opening it.
+    static double aesGcmRound(const unsigned round, Digest& digest, const CpuDispatch::Gcm engine) {
+        PcgLanes gen(SDC_SEED, round);
+        std::vector<uint8_t> record(AES_GCM_RECORD_BYTES), sealed(AES_GCM_RECORD_BYTES);
+        uint8_t key_bytes[32], aad[AES_GCM_AAD_BYTES], iv[Aes::GCM_IV_BYTES], tag[Aes::BLOCK];
+        gen.fillBytes(record.data(), record.size());
+        gen.fillBytes(key_bytes, sizeof(key_bytes));
+        gen.fillBytes(aad, sizeof(aad));
+        gen.fillBytes(iv, sizeof(iv));
+        const Aes::GcmKey key = Aes::gcmExpand(key_bytes, sizeof(key_bytes));
+        Aes::gcmEncrypt(engine, key, iv, aad, sizeof(aad), record.data(), sealed.data(), record.size(), tag);
+        digest.add(sealed.data(), sealed.size());
+        digest.add(tag, sizeof(tag));
+        const uint8_t authentic = Aes::gcmDecrypt(engine, key, iv, aad, sizeof(aad), sealed.data(), record.data(), record.size(), tag);
+        digest.add(record.data(), record.size());
+        digest.add(&authentic, sizeof(authentic));
+        return 2.0 * AES_GCM_RECORD_BYTES;
     }
-    static double diskWriteWorker(unsigned long iterations, int tid){
-        pinThread(tid);
-        const auto start = std::chrono::high_resolution_clock::now();
+
+    static void diskWriteWorker(const RunControl& run, ProgressCounter& progress, int tid){
         std::string filename = "/tmp/writeTestThread" + std::to_string(tid) + ".bin";
-        for (int i = 0; i < iterations; ++i) {
-            diskWrite(filename.c_str());
+        while (!run.stopped()) {
+            progress.add(diskWrite(filename.c_str(), run.flag()));
         }
-        const auto end = std::chrono::high_resolution_clock::now();
-        const std::chrono::duration<double> elapsed = end - start;
-        std::cout << iterations / elapsed.count() << "\n";
-        return iterations / elapsed.count();
     }
 };
 
 int main() {
-    esst().init();
-    return 0;
+    return esst().init();
 }
@@ -0,0 +1,105 @@
+#include "millerRabin.hpp"
+#include "cpuDispatch.hpp"
+#include <algorithm>
+
+namespace {
+
+// Together these decide every n < 2^64; a base that is 0 mod n is skipped
+constexpr uint64_t BASES[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+using u128 = unsigned __int128;
+
+// Montgomery reduction t / 2^64 mod n for t < n^2, by subtraction so that n may use all 64 bits:
+// m*n matches t in the low word, so the difference of the high words is exact.
+[[gnu::always_inline]] inline uint64_t redc(const u128 t, const uint64_t n, const uint64_t inverse) {
+    const uint64_t m = static_cast<uint64_t>(t) * inverse;
+    const auto high = static_cast<uint64_t>(t >> 64);
+    const auto mn = static_cast<uint64_t>(static_cast<u128>(m) * n >> 64);
+    return high >= mn ? high - mn : high - mn + n;
+}
+
+template <size_t Chains>
+[[gnu::always_inline]] inline void testGroup(const uint64_t* candidates, uint8_t* prime) {
+    uint64_t n[Chains], inverse[Chains], one[Chains], minus_one[Chains], r2[Chains], d[Chains];
+    unsigned s[Chains];
+    bool composite[Chains], trivial[Chains];
+    unsigned top = 0, squarings = 0;
+    for (size_t l = 0; l < Chains; ++l) {
+        // Below 3 and even values are decided here; their chain runs on 3 and is discarded
+        trivial[l] = candidates[l] < 3 || !(candidates[l] & 1);
+        prime[l] = candidates[l] == 2;
+        composite[l] = trivial[l];
+        n[l] = trivial[l] ? 3 : candidates[l];
+        uint64_t x = n[l]; // n * n = 1 mod 8, and each Newton step doubles the correct bits
+        for (int i = 0; i < 5; ++i) x *= 2 - n[l] * x;
+        inverse[l] = x;
+        one[l] = -n[l] % n[l];
+        minus_one[l] = n[l] - one[l];
+        r2[l] = static_cast<uint64_t>(static_cast<u128>(one[l]) * one[l] % n[l]);
+        s[l] = __builtin_ctzll(n[l] - 1);
+        d[l] = (n[l] - 1) >> s[l];
+        top = std::max(top, 64u - __builtin_clzll(d[l]));
+        squarings = std::max(squarings, s[l]);
+    }
+
+    for (const uint64_t base : BASES) {
+        if (std::all_of(composite, composite + Chains, [](const bool c) { return c; })) break;
+        uint64_t a[Chains], x[Chains];
+        bool skip[Chains];
+        for (size_t l = 0; l < Chains; ++l) {
+            const uint64_t reduced = base % n[l];
+            skip[l] = reduced == 0;
+            a[l] = redc(static_cast<u128>(reduced) * r2[l], n[l], inverse[l]);
+            x[l] = one[l];
+        }
+        // a^d, left to right over the longest d; shorter exponents square 1 until their top bit
+        for (unsigned bit = top; bit-- > 0;) {
+            for (size_t l = 0; l < Chains; ++l) {
+                x[l] = redc(static_cast<u128>(x[l]) * x[l], n[l], inverse[l]);
+                const uint64_t product = redc(static_cast<u128>(x[l]) * a[l], n[l], inverse[l]);
+                x[l] = d[l] >> bit & 1 ? product : x[l];
+            }
+        }
+        bool passed[Chains];
+        for (size_t l = 0; l < Chains; ++l) passed[l] = skip[l] || x[l] == one[l] || x[l] == minus_one[l];
+        for (unsigned r = 1; r < squarings; ++r) {
+            for (size_t l = 0; l < Chains; ++l) {
+                x[l] = redc(static_cast<u128>(x[l]) * x[l], n[l], inverse[l]);
+                if (r < s[l] && x[l] == minus_one[l]) passed[l] = true;
+            }
+        }
+        for (size_t l = 0; l < Chains; ++l) composite[l] |= !passed[l];
+    }
+    for (size_t l = 0; l < Chains; ++l)
+        if (!trivial[l]) prime[l] = !composite[l];
+}
+
+template <size_t Chains>
+[[gnu::always_inline]] inline void testAll(const uint64_t* n, uint8_t* prime, const size_t count) {
+    size_t i = 0;
+    for (; i + Chains <= count; i += Chains) testGroup<Chains>(n + i, prime + i);
+    for (; i < count; ++i) testGroup<1>(n + i, prime + i);
+}
+
+void batchPortable(const uint64_t* n, uint8_t* prime, const size_t count) { testAll<MillerRabin::CHAINS>(n, prime, count); }
+
+__attribute__((target("bmi2"))) void batchBmi2(const uint64_t* n, uint8_t* prime, const size_t count) {
+    testAll<MillerRabin::CHAINS>(n, prime, count);
+}
+
+} // namespace
+
+bool MillerRabin::isPrime(const uint64_t n) {
+    uint8_t prime;
+    batch(&n, &prime, 1);
+    return prime;
+}
+
+void MillerRabin::batch(const uint64_t* n, uint8_t* prime, const size_t count) {
+    if (CpuDispatch::get().features().bmi2) batchBmi2(n, prime, count);
+    else batchPortable(n, prime, count);
+}
+
+const char* MillerRabin::name() {
+    return CpuDispatch::get().features().bmi2 ? "Montgomery, 4 chains, mulx" : "Montgomery, 4 chains, mul";
+}
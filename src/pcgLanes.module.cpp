@@ -0,0 +1,153 @@
+#include "pcgLanes.hpp"
+#include "cpuDispatch.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t MULTIPLIER = 6364136223846793005ULL; // pcg32's LCG multiplier
+constexpr size_t CHUNK = 1024;                           // values converted per stepper call
+
+uint32_t output(const uint64_t old) {
+    const auto xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+    const auto rot = static_cast<uint32_t>(old >> 59);
+    return xorshifted >> rot | xorshifted << ((32 - rot) & 31);
+}
+
+void stepScalar(uint64_t* state, const uint64_t* inc, uint32_t* out, const size_t blocks) {
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t l = 0; l < PcgLanes::LANES; ++l) {
+            const uint64_t old = state[l];
+            state[l] = old * MULTIPLIER + inc[l];
+            out[b * PcgLanes::LANES + l] = output(old);
+        }
+    }
+}
+
+// 64-bit lanes have no low multiply before AVX-512DQ: lo*lo plus the two cross products shifted up.
+// The 32-bit rotate is done in 64-bit lanes on the zero-extended value, then masked.
+__attribute__((target("avx2"))) inline __m256i stepAvx2(__m256i& state, const __m256i inc, const __m256i mul_lo,
+                                                        const __m256i mul_hi) {
+    const __m256i old = state;
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(old, mul_hi), _mm256_mul_epu32(_mm256_srli_epi64(old, 32), mul_lo));
+    state = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(old, mul_lo), _mm256_slli_epi64(cross, 32)), inc);
+
+    const __m256i low32 = _mm256_set1_epi64x(0xffffffff);
+    const __m256i xorshifted = _mm256_and_si256(_mm256_srli_epi64(_mm256_xor_si256(_mm256_srli_epi64(old, 18), old), 27), low32);
+    const __m256i rot = _mm256_srli_epi64(old, 59);
+    const __m256i left = _mm256_and_si256(_mm256_sub_epi64(_mm256_set1_epi64x(32), rot), _mm256_set1_epi64x(31));
+    return _mm256_and_si256(_mm256_or_si256(_mm256_srlv_epi64(xorshifted, rot), _mm256_sllv_epi64(xorshifted, left)), low32);
+}
+
+__attribute__((target("avx2"))) void stepAvx2Lanes(uint64_t* state, const uint64_t* inc, uint32_t* out, const size_t blocks) {
+    const __m256i mul_lo = _mm256_set1_epi64x(MULTIPLIER & 0xffffffff);
+    const __m256i mul_hi = _mm256_set1_epi64x(MULTIPLIER >> 32);
+    const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7); // low halves of the four 64-bit lanes first
+    __m256i s[4], c[4];
+    for (int v = 0; v < 4; ++v) {
+        s[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 4 * v));
+        c[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inc + 4 * v));
+    }
+    for (size_t b = 0; b < blocks; ++b) {
+        for (int v = 0; v < 4; ++v) {
+            const __m256i words = _mm256_permutevar8x32_epi32(stepAvx2(s[v], c[v], mul_lo, mul_hi), pack);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + b * PcgLanes::LANES + 4 * v), _mm256_castsi256_si128(words));
+        }
+    }
+    for (int v = 0; v < 4; ++v) _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 4 * v), s[v]);
+}
+
+// GCC 12 flags the intrinsics' internal undefined operands when AVX-512 is enabled per function
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f"))) void stepAvx512Lanes(uint64_t* state, const uint64_t* inc, uint32_t* out, const size_t blocks) {
+    const __m512i mul_lo = _mm512_set1_epi64(MULTIPLIER & 0xffffffff);
+    const __m512i mul_hi = _mm512_set1_epi64(MULTIPLIER >> 32);
+    const __m512i low32 = _mm512_set1_epi64(0xffffffff);
+    __m512i s[2], c[2];
+    for (int v = 0; v < 2; ++v) {
+        s[v] = _mm512_loadu_si512(state + 8 * v);
+        c[v] = _mm512_loadu_si512(inc + 8 * v);
+    }
+    for (size_t b = 0; b < blocks; ++b) {
+        for (int v = 0; v < 2; ++v) {
+            const __m512i old = s[v];
+            const __m512i cross = _mm512_add_epi64(_mm512_mul_epu32(old, mul_hi), _mm512_mul_epu32(_mm512_srli_epi64(old, 32), mul_lo));
+            s[v] = _mm512_add_epi64(_mm512_add_epi64(_mm512_mul_epu32(old, mul_lo), _mm512_slli_epi64(cross, 32)), c[v]);
+
+            const __m512i xorshifted = _mm512_and_si512(_mm512_srli_epi64(_mm512_xor_si512(_mm512_srli_epi64(old, 18), old), 27), low32);
+            const __m512i rot = _mm512_srli_epi64(old, 59);
+            const __m512i left = _mm512_and_si512(_mm512_sub_epi64(_mm512_set1_epi64(32), rot), _mm512_set1_epi64(31));
+            const __m512i words = _mm512_or_si512(_mm512_srlv_epi64(xorshifted, rot), _mm512_sllv_epi64(xorshifted, left));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + b * PcgLanes::LANES + 8 * v), _mm512_cvtepi64_epi32(words));
+        }
+    }
+    for (int v = 0; v < 2; ++v) _mm512_storeu_si512(state + 8 * v, s[v]);
+}
+#pragma GCC diagnostic pop
+
+} // namespace
+
+PcgLanes::Stepper PcgLanes::stepper() {
+    switch (CpuDispatch::get().vector()) {
+    case CpuDispatch::Vector::Avx512: return stepAvx512Lanes;
+    case CpuDispatch::Vector::Avx2: return stepAvx2Lanes;
+    default: return stepScalar;
+    }
+}
+
+PcgLanes::PcgLanes(const uint64_t seed, const uint64_t stream) : step_(stepper()) {
+    // pcg32's seeding, once per lane
+    for (size_t l = 0; l < LANES; ++l) {
+        inc_[l] = (stream * LANES + l) << 1 | 1;
+        state_[l] = inc_[l];
+        state_[l] += seed;
+        state_[l] = state_[l] * MULTIPLIER + inc_[l];
+    }
+}
+
+void PcgLanes::fill(uint32_t* out, const size_t count) {
+    const size_t blocks = count / LANES;
+    step_(state_, inc_, out, blocks);
+    if (const size_t tail = count % LANES) {
+        uint32_t block[LANES];
+        step_(state_, inc_, block, 1);
+        std::copy_n(block, tail, out + blocks * LANES);
+    }
+}
+
+void PcgLanes::fillBytes(uint8_t* out, const size_t count) {
+    uint32_t words[CHUNK];
+    for (size_t done = 0; done < count; done += sizeof(words)) {
+        const size_t n = std::min(sizeof(words), count - done);
+        fill(words, (n + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        std::memcpy(out + done, words, n);
+    }
+}
+
+void PcgLanes::fillUniform(float* out, const size_t count, const float lower, const float upper) {
+    uint32_t words[CHUNK];
+    const float scale = (upper - lower) * 0x1p-24f;
+    for (size_t done = 0; done < count; done += CHUNK) {
+        const size_t n = std::min(CHUNK, count - done);
+        fill(words, n);
+        for (size_t i = 0; i < n; ++i) out[done + i] = lower + static_cast<float>(words[i] >> 8) * scale;
+    }
+}
+
+void PcgLanes::fillUniform(uint64_t* out, const size_t count, const uint64_t lower, const uint64_t upper) {
+    uint32_t words[CHUNK];
+    const uint64_t span = upper - lower; // the range holds span + 1 values
+    for (size_t done = 0; done < count; done += CHUNK / 2) {
+        const size_t n = std::min(CHUNK / 2, count - done);
+        fill(words, 2 * n);
+        for (size_t i = 0; i < n; ++i) {
+            const uint64_t x = static_cast<uint64_t>(words[2 * i]) << 32 | words[2 * i + 1];
+            // Multiply-shift maps x onto the range; its bias is at most span / 2^64
+            out[done + i] = span == UINT64_MAX
+                ? x
+                : lower + static_cast<uint64_t>((static_cast<unsigned __int128>(x) * (span + 1)) >> 64);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include "perfCounters.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t cacheMiss(const uint64_t cache) {
+    return cache | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+}
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr std::array<EventConfig, PerfCounters::EVENT_COUNT> EVENTS = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB)},
+}};
+
+int openEvent(const EventConfig& event) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+std::string paranoidLevel() {
+    std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+    std::string level;
+    return file >> level ? level : "?";
+}
+
+// Empty if the counters work
+std::string probe() {
+    const int fd = openEvent(EVENTS[PerfCounters::Instructions]);
+    if (fd >= 0) {
+        close(fd);
+        return {};
+    }
+    switch (errno) {
+    case EACCES:
+    case EPERM:
+        return "denied by perf_event_paranoid=" + paranoidLevel() + " (lower it or grant CAP_PERFMON)";
+    case ENOENT:
+    case ENODEV:
+    case EOPNOTSUPP:
+        return "no hardware PMU exposed to this kernel (common in VMs and containers)";
+    case ENOSYS:
+        return "kernel built without perf events";
+    default:
+        return std::strerror(errno);
+    }
+}
+
+} // namespace
+
+double PerfCounters::Counts::ipc() const {
+    return has(Instructions) && has(Cycles) && value[Cycles] > 0 ? value[Instructions] / value[Cycles] : 0.0;
+}
+
+double PerfCounters::Counts::mpki(const Event event) const {
+    return has(event) && has(Instructions) && value[Instructions] > 0 ? value[event] * 1000.0 / value[Instructions] : 0.0;
+}
+
+const std::string& PerfCounters::unavailableReason() {
+    static const std::string reason = probe();
+    return reason;
+}
+
+bool PerfCounters::available() {
+    return unavailableReason().empty();
+}
+
+const char* PerfCounters::name(const Event event) {
+    switch (event) {
+    case Instructions: return "instructions";
+    case Cycles: return "cycles";
+    case L1dMisses: return "L1D";
+    case LlcMisses: return "LLC";
+    case BranchMisses: return "branch";
+    case DtlbMisses: return "dTLB";
+    case EVENT_COUNT: break;
+    }
+    return "?";
+}
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+    if (!available()) return;
+    for (size_t i = 0; i < EVENTS.size(); ++i) fds_[i] = openEvent(EVENTS[i]);
+}
+
+PerfCounters::~PerfCounters() {
+    for (const int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+void PerfCounters::start() {
+    for (const int fd : fds_) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfCounters::Counts PerfCounters::stop() {
+    Counts counts;
+    for (const int fd : fds_) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (size_t i = 0; i < fds_.size(); ++i) {
+        struct { uint64_t value, enabled, running; } data;
+        if (fds_[i] < 0 || read(fds_[i], &data, sizeof(data)) != sizeof(data) || data.running == 0) continue;
+        counts.value[i] = static_cast<double>(data.value) * data.enabled / data.running;
+        counts.valid[i] = true;
+    }
+    return counts;
+}
@@ -0,0 +1,140 @@
+#include "primeSieve.hpp"
+#include "runControl.hpp"
+#include "progress.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t WHEEL = 30;
+constexpr uint8_t RESIDUES[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+constexpr uint8_t GAPS[8] = {6, 4, 2, 4, 2, 4, 6, 2}; // from each residue to the next
+constexpr size_t DEFAULT_L2 = 512 * 1024;
+constexpr size_t MIN_SEGMENT = 16 * 1024;
+constexpr size_t MAX_SEGMENT = 2 * 1024 * 1024;
+
+// Bit of residue r in a wheel byte, -1 for residues sharing a factor with 30
+constexpr auto BIT_OF = [] {
+    std::array<int8_t, WHEEL> bits{};
+    bits.fill(-1);
+    for (int8_t i = 0; i < 8; ++i) bits[RESIDUES[i]] = i;
+    return bits;
+}();
+
+size_t halfL2Bytes() {
+    const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    const size_t half = (l2 > 0 ? static_cast<size_t>(l2) : DEFAULT_L2) / 2;
+    return std::clamp(half & ~size_t{63}, MIN_SEGMENT, MAX_SEGMENT);
+}
+
+} // namespace
+
+PrimeSieve::PrimeSieve(const uint64_t limit, const unsigned threads)
+    : limit_(std::min(limit, MAX_LIMIT)), segment_bytes_(halfL2Bytes()), shares_(threads), working_(threads) {
+    segment_count_ = limit_ / (WHEEL * segment_bytes_) + 1;
+
+    // Plain sieve of the odd numbers up to sqrt(limit) for the sieving primes
+    uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(limit_)));
+    while (root * root > limit_) --root;
+    while ((root + 1) * (root + 1) <= limit_) ++root;
+    std::vector<bool> composite(root + 1);
+    for (uint64_t p = 3; p * p <= root; p += 2)
+        if (!composite[p])
+            for (uint64_t m = p * p; m <= root; m += 2 * p) composite[m] = true;
+    for (uint64_t p = 7; p <= root; p += 2)
+        if (!composite[p]) sieving_.push_back(static_cast<uint32_t>(p));
+}
+
+void PrimeSieve::sieveSegment(const uint64_t segment, std::vector<uint8_t>& bits) const {
+    const uint64_t low = segment * WHEEL * segment_bytes_;
+    const uint64_t high = low + WHEEL * segment_bytes_; // exclusive
+    std::memset(bits.data(), 0xff, segment_bytes_);
+    if (segment == 0) bits[0] &= 0xfe; // 1 is not prime
+
+    for (const uint64_t p : sieving_) {
+        if (p * p >= high) break;
+        // First multiple p*m in the segment with m coprime to 30 and m >= p
+        uint64_t m = std::max(p, (std::max(low, p * p) + p - 1) / p);
+        while (BIT_OF[m % WHEEL] < 0) ++m;
+        unsigned index = BIT_OF[m % WHEEL];
+        // The next eight such m cover every residue class of p*m; within a class p*m steps by 30p,
+        // which is p bytes at a fixed bit
+        for (int k = 0; k < 8; ++k) {
+            const uint64_t n = p * m;
+            if (n >= high) break;
+            const auto mask = static_cast<uint8_t>(~(1u << BIT_OF[n % WHEEL]));
+            for (uint64_t byte = (n - low) / WHEEL; byte < segment_bytes_; byte += p) bits[byte] &= mask;
+            m += GAPS[index];
+            index = (index + 1) & 7;
+        }
+    }
+
+    // Drop the residues past the limit in the last segment
+    if (limit_ < high - 1) {
+        const uint64_t last = (limit_ - low) / WHEEL;
+        uint8_t keep = 0;
+        for (int i = 0; i < 8; ++i)
+            if (low + last * WHEEL + RESIDUES[i] <= limit_) keep |= static_cast<uint8_t>(1u << i);
+        bits[last] &= keep;
+        std::memset(bits.data() + last + 1, 0, segment_bytes_ - last - 1);
+    }
+}
+
+void PrimeSieve::work(const unsigned thread, RunControl& run, ProgressCounter& progress) {
+    Share& share = shares_[thread];
+    std::vector<uint8_t> bits(segment_bytes_);
+    while (!run.stopped()) {
+        const uint64_t segment = next_segment_.fetch_add(1);
+        if (segment >= segment_count_) break;
+        sieveSegment(segment, bits);
+        uint64_t primes = 0;
+        for (size_t i = 0; i < segment_bytes_; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, bits.data() + i, sizeof(word));
+            primes += std::popcount(word);
+        }
+        share.primes += primes;
+        segments_done_.fetch_add(1);
+        progress.add(static_cast<double>(primes));
+    }
+    if (working_.fetch_sub(1) == 1) run.requestStop();
+}
+
+uint64_t PrimeSieve::count() const {
+    uint64_t total = 0;
+    for (const auto& share : shares_) total += share.primes;
+    // 2, 3 and 5 are off the wheel
+    for (const uint64_t p : {2, 3, 5})
+        if (p <= limit_) ++total;
+    return total;
+}
+
+void PrimeSieve::primality(const uint64_t lower, const size_t count, uint8_t* prime) const {
+    const uint64_t end = lower + count;
+    std::fill_n(prime, count, 1);
+    for (uint64_t n = lower; n < std::min<uint64_t>(end, 2); ++n) prime[n - lower] = 0;
+    const auto strike = [&](const uint64_t p) {
+        for (uint64_t m = std::max(p * p, (lower + p - 1) / p * p); m < end; m += p) prime[m - lower] = 0;
+    };
+    for (const uint64_t p : {2, 3, 5}) strike(p);
+    for (const uint64_t p : sieving_) {
+        if (p * p >= end) break;
+        strike(p);
+    }
+}
+
+std::optional<uint64_t> PrimeSieve::knownCount(const uint64_t x) {
+    static constexpr uint64_t POWERS_OF_TEN[] = {0, 4, 25, 168, 1229, 9592, 78498, 664579, 5761455, 50847534, 455052511,
+                                                 4118054813, 37607912018, 346065536839, 3204941750802};
+    if (x == uint64_t{1} << 32) return 203280221;
+    uint64_t power = 1;
+    for (const uint64_t count : POWERS_OF_TEN) {
+        if (x == power) return count;
+        power *= 10;
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,139 @@
+#include "progress.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+constexpr size_t LIVE_COLUMNS = 4;   // threads per line of the live display
+constexpr size_t TIMELINE_ROWS = 20; // longer runs are merged into this many timeline rows
+}
+
+ProgressSampler::ProgressSampler(const std::vector<ProgressCounter>& counters, std::vector<std::string> labels,
+                                 Formatter format, const std::chrono::milliseconds interval)
+    : counters_(counters), labels_(std::move(labels)), format_(std::move(format)),
+      interval_(std::chrono::duration_cast<Clock::duration>(interval)), live_(isatty(STDOUT_FILENO)) {}
+
+ProgressSampler::~ProgressSampler() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void ProgressSampler::start(const Clock::time_point origin) {
+    timeline_.push_back({0.0, std::vector<double>(counters_.size(), 0.0)});
+    thread_ = std::thread([this, origin] {
+        std::unique_lock lock(mutex_);
+        for (auto next = origin + interval_; !wake_.wait_until(lock, next, [this] { return stopping_; }); next += interval_) {
+            sample(std::chrono::duration<double>(Clock::now() - origin).count());
+            if (live_) draw();
+        }
+    });
+}
+
+void ProgressSampler::stop(const double window) {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+
+    // A tick racing the stop request lands on or just before the window end; fold it into the
+    // final interval rather than keep a sliver whose rate is mostly quantisation noise
+    const double min_gap = std::chrono::duration<double>(interval_).count() / 4;
+    while (timeline_.size() > 1 && timeline_.back().time > window - min_gap) timeline_.pop_back();
+    sample(window);
+}
+
+void ProgressSampler::sample(const double time) {
+    Sample sample{time, {}};
+    sample.units.reserve(counters_.size());
+    for (const auto& counter : counters_) sample.units.push_back(counter.units());
+    timeline_.push_back(std::move(sample));
+}
+
+double ProgressSampler::intervalRate(const size_t sample, const size_t thread) const {
+    const double dt = timeline_[sample].time - timeline_[sample - 1].time;
+    return dt > 0 ? (timeline_[sample].units[thread] - timeline_[sample - 1].units[thread]) / dt : 0.0;
+}
+
+void ProgressSampler::draw() {
+    const size_t last = timeline_.size() - 1;
+    std::ostringstream frame;
+    if (drawn_lines_ > 0) frame << "\033[" << drawn_lines_ << "F";
+
+    double total = 0;
+    for (size_t t = 0; t < counters_.size(); ++t) total += intervalRate(last, t);
+    frame << "\033[2K" << "t=" << std::fixed << std::setprecision(0) << timeline_[last].time << " s | Total: " << format_(total);
+    unsigned lines = 1;
+    for (size_t t = 0; t < counters_.size(); ++t) {
+        if (t % LIVE_COLUMNS == 0) {
+            frame << "\n\033[2K";
+            ++lines;
+        }
+        frame << std::left << std::setw(8) << labels_[t] << std::setw(20) << format_(intervalRate(last, t));
+    }
+    frame << "\n";
+    drawn_lines_ = lines;
+    std::cout << frame.str() << std::flush;
+}
+
+std::vector<double> ProgressSampler::rates() const {
+    const Sample& last = timeline_.back();
+    std::vector<double> rates(last.units.size(), 0.0);
+    if (last.time <= 0) return rates;
+    for (size_t t = 0; t < rates.size(); ++t) rates[t] = last.units[t] / last.time;
+    return rates;
+}
+
+void ProgressSampler::report(std::ostream& out) const {
+    const size_t intervals = timeline_.size() - 1;
+    if (intervals < 2) return;
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << "\n====== THROUGHPUT TIMELINE ======\n";
+    const size_t step = (intervals + TIMELINE_ROWS - 1) / TIMELINE_ROWS;
+    for (size_t begin = 0; begin < intervals; begin += step) {
+        const Sample& from = timeline_[begin];
+        const Sample& to = timeline_[std::min(begin + step, intervals)];
+        const double dt = to.time - from.time;
+        double total = 0, slowest = 0;
+        size_t slowest_thread = 0;
+        for (size_t t = 0; t < counters_.size(); ++t) {
+            const double rate = (to.units[t] - from.units[t]) / dt;
+            total += rate;
+            if (t == 0 || rate < slowest) slowest = rate, slowest_thread = t;
+        }
+        out << std::right << std::fixed << std::setprecision(1) << std::setw(7) << to.time << " s  "
+            << std::left << std::setw(20) << format_(total)
+            << "slowest " << labels_[slowest_thread] << " " << format_(slowest) << "\n";
+    }
+
+    // Each thread's worst interval, and how its second half compares to its first
+    out << "-------------------------------\n";
+    const Sample& last = timeline_.back();
+    const auto mid = std::ranges::min_element(timeline_, {}, [&](const Sample& s) { return std::abs(s.time - last.time / 2); });
+    for (size_t t = 0; t < counters_.size(); ++t) {
+        size_t worst = 1;
+        for (size_t k = 2; k < timeline_.size(); ++k) {
+            if (intervalRate(k, t) < intervalRate(worst, t)) worst = k;
+        }
+        out << std::left << std::setw(8) << labels_[t] << "min " << std::setw(20) << format_(intervalRate(worst, t))
+            << "at " << std::fixed << std::setprecision(1) << timeline_[worst].time << " s";
+        if (mid->time > 0 && mid->time < last.time && mid->units[t] > 0) {
+            const double first = mid->units[t] / mid->time;
+            const double second = (last.units[t] - mid->units[t]) / (last.time - mid->time);
+            out << " | 2nd half " << std::showpos << (second / first - 1.0) * 100.0 << std::noshowpos << "%";
+        }
+        out << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,298 @@
+#include "resultLog.hpp"
+#include "sensors.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace {
+
+constexpr auto CSV_HEADER = "timestamp,command,cpu_model,kernel,thread,cpu,throughput,unit,duration_s,clock_mhz,instructions_per_s,ipc,"
+                            "cpu_temp_start_c,cpu_temp_end_c,cpu_temp_max_c,gpu_temp_max_c";
+
+std::string csvField(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) return value;
+    std::string quoted = "\"";
+    for (const char c : value) quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+    return quoted + "\"";
+}
+
+std::vector<std::string> splitCsv(const std::string& line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        const char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') fields.back() += line[++i];
+            else if (c == '"') quoted = false;
+            else fields.back() += c;
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else if (c != '\r') {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+std::string jsonString(const std::string& value) {
+    std::ostringstream out;
+    out << '"';
+    for (const char c : value) {
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+            else out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+std::string optionalNumber(const std::optional<float>& value, const char* none) {
+    if (!value) return none;
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << *value;
+    return out.str();
+}
+
+struct Total {
+    double throughput = 0;
+    std::string unit;
+    unsigned threads = 0;
+};
+
+// Per kernel: the sum of its aggregate rows if it has any, otherwise the sum over its threads.
+std::map<std::string, Total> totals(const std::vector<ResultLog::Record>& records) {
+    std::map<std::string, Total> aggregate, per_thread;
+    for (const auto& r : records) {
+        auto& total = (r.thread < 0 ? aggregate : per_thread)[r.kernel];
+        total.throughput += r.throughput;
+        total.unit = r.unit;
+        if (r.thread >= 0) ++total.threads;
+    }
+    for (const auto& [kernel, total] : per_thread) {
+        if (!aggregate.contains(kernel)) aggregate[kernel] = total;
+        else aggregate[kernel].threads = total.threads;
+    }
+    return aggregate;
+}
+
+std::string formatTime(const std::time_t time, const char* format) {
+    std::tm utc{};
+    gmtime_r(&time, &utc);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), format, &utc);
+    return buffer;
+}
+
+} // namespace
+
+ResultLog& ResultLog::shared() {
+    static ResultLog log;
+    return log;
+}
+
+void ResultLog::setMachine(std::string cpu_model, std::string version) {
+    cpu_model_ = std::move(cpu_model);
+    version_ = std::move(version);
+}
+
+void ResultLog::beginRun(const std::string& command) {
+    command_ = command;
+    timestamp_ = formatTime(std::time(nullptr), "%Y-%m-%dT%H:%M:%SZ");
+    records_.clear();
+    failures_.clear();
+    temps_ = {};
+    temps_.cpu_start = temps_.cpu_max = Sensors::cpuTemp();
+    temps_.gpu_max = Sensors::gpuTemp();
+    active_ = true;
+    stopping_ = false;
+    sampler_ = std::thread([this] {
+        std::unique_lock lock(mutex_);
+        while (!wake_.wait_for(lock, std::chrono::seconds(1), [this] { return stopping_; })) {
+            lock.unlock();
+            sampleTemperatures();
+            lock.lock();
+        }
+    });
+}
+
+void ResultLog::sampleTemperatures() {
+    const auto cpu = Sensors::cpuTemp();
+    const auto gpu = Sensors::gpuTemp();
+    std::lock_guard lock(mutex_);
+    if (cpu && (!temps_.cpu_max || *cpu > *temps_.cpu_max)) temps_.cpu_max = cpu;
+    if (gpu && (!temps_.gpu_max || *gpu > *temps_.gpu_max)) temps_.gpu_max = gpu;
+}
+
+void ResultLog::record(Record record) {
+    std::lock_guard lock(mutex_);
+    if (active_) records_.push_back(std::move(record));
+}
+
+void ResultLog::fail(std::string reason) {
+    std::lock_guard lock(mutex_);
+    failures_.push_back(std::move(reason));
+    failed_ = true;
+}
+
+bool ResultLog::endRun() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (sampler_.joinable()) sampler_.join();
+    sampleTemperatures();
+    temps_.cpu_end = Sensors::cpuTemp();
+    active_ = false;
+
+    if (records_.empty()) return failures_.empty();
+    write();
+    const bool passed = (!baseline_ || compare()) && failures_.empty();
+    failed_ |= !passed;
+    return passed;
+}
+
+void ResultLog::write() const {
+    const char* env = std::getenv("ESST_RESULTS_DIR");
+    const std::filesystem::path dir = env && *env ? env : "esst-results";
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (error) {
+        std::cerr << "Cannot create results directory " << dir << ": " << error.message() << "\n";
+        return;
+    }
+
+    std::string stem = timestamp_;
+    std::ranges::replace(stem, ':', '-');
+    stem = "esst-" + stem + "-" + command_;
+
+    std::ofstream json(dir / (stem + ".json"));
+    json << std::setprecision(10)
+         << "{\n"
+         << "  \"version\": " << jsonString(version_) << ",\n"
+         << "  \"timestamp\": " << jsonString(timestamp_) << ",\n"
+         << "  \"command\": " << jsonString(command_) << ",\n"
+         << "  \"cpu_model\": " << jsonString(cpu_model_) << ",\n"
+         << "  \"temperatures\": {\"cpu_start_c\": " << optionalNumber(temps_.cpu_start, "null")
+         << ", \"cpu_end_c\": " << optionalNumber(temps_.cpu_end, "null")
+         << ", \"cpu_max_c\": " << optionalNumber(temps_.cpu_max, "null")
+         << ", \"gpu_max_c\": " << optionalNumber(temps_.gpu_max, "null") << "},\n"
+         << "  \"failures\": [";
+    for (size_t i = 0; i < failures_.size(); ++i) json << (i ? ", " : "") << jsonString(failures_[i]);
+    json << "],\n"
+         << "  \"results\": [\n";
+    for (size_t i = 0; i < records_.size(); ++i) {
+        const auto& r = records_[i];
+        json << "    {\"kernel\": " << jsonString(r.kernel) << ", \"thread\": " << r.thread << ", \"cpu\": " << r.cpu
+             << ", \"throughput\": " << r.throughput << ", \"unit\": " << jsonString(r.unit)
+             << ", \"duration_s\": " << r.duration << ", \"clock_mhz\": " << r.mhz
+             << ", \"instructions_per_s\": " << r.instructions << ", \"ipc\": " << r.ipc << "}" << (i + 1 < records_.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+
+    std::ofstream csv(dir / (stem + ".csv"));
+    csv << std::setprecision(10) << CSV_HEADER << "\n";
+    for (const auto& r : records_) {
+        csv << timestamp_ << "," << csvField(command_) << "," << csvField(cpu_model_) << "," << csvField(r.kernel) << ","
+            << r.thread << "," << r.cpu << "," << r.throughput << "," << csvField(r.unit) << "," << r.duration << "," << r.mhz << ","
+            << r.instructions << "," << r.ipc << ","
+            << optionalNumber(temps_.cpu_start, "") << "," << optionalNumber(temps_.cpu_end, "") << ","
+            << optionalNumber(temps_.cpu_max, "") << "," << optionalNumber(temps_.gpu_max, "") << "\n";
+    }
+
+    if (!json || !csv) std::cerr << "Failed to write results to " << dir / stem << ".{json,csv}\n";
+    else std::cout << "Results: " << (dir / stem).string() << ".{json,csv}\n";
+}
+
+bool ResultLog::loadBaseline(const std::string& path, const double tolerance) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open baseline " << path << "\n";
+        return false;
+    }
+
+    Baseline baseline{path, {}, {}, tolerance};
+    size_t rows = 0;
+    std::map<std::string, size_t> column;
+    std::string line;
+    while (std::getline(file, line)) {
+        const auto fields = splitCsv(line);
+        if (fields.front() == "timestamp") { // header, possibly repeated in concatenated files
+            column.clear();
+            for (size_t i = 0; i < fields.size(); ++i) column[fields[i]] = i;
+            continue;
+        }
+        const auto field = [&](const char* name) -> std::string {
+            const auto it = column.find(name);
+            return it != column.end() && it->second < fields.size() ? fields[it->second] : std::string();
+        };
+        try {
+            baseline.cpu_model = field("cpu_model");
+            baseline.runs[field("command")].push_back({field("kernel"), std::stoi(field("thread")), std::stoi(field("cpu")),
+                                                       std::stod(field("throughput")), field("unit"), std::stod(field("duration_s"))});
+            ++rows;
+        } catch (...) {} // blank or malformed row
+    }
+    if (rows == 0) {
+        std::cerr << "Baseline " << path << " holds no results\n";
+        return false;
+    }
+    baseline_ = std::move(baseline);
+    return true;
+}
+
+bool ResultLog::compare() const {
+    // Kernels are only compared within the same command; a mix slot and a standalone run differ
+    const auto run = baseline_->runs.find(command_);
+    std::cout << "\n====== BASELINE CHECK (" << baseline_->path << ", +/-" << baseline_->tolerance * 100.0 << "%) ======\n";
+    if (run == baseline_->runs.end()) {
+        std::cout << "No baseline for '" << command_ << "'\n";
+        std::cout << "======================================\n";
+        return true;
+    }
+    const auto now = totals(records_);
+    const auto base = totals(run->second);
+    const auto flags = std::cout.flags();
+
+    if (baseline_->cpu_model != cpu_model_) {
+        std::cout << "WARNING: baseline was recorded on \"" << baseline_->cpu_model << "\"\n";
+    }
+    bool passed = true;
+    for (const auto& [kernel, total] : now) {
+        std::cout << std::left << std::setw(10) << kernel << std::right;
+        const auto it = base.find(kernel);
+        if (it == base.end() || it->second.throughput <= 0) {
+            std::cout << "no baseline\n";
+            continue;
+        }
+        const double delta = total.throughput / it->second.throughput - 1.0;
+        const bool ok = std::abs(delta) <= baseline_->tolerance;
+        passed &= ok;
+        std::cout << std::setprecision(4) << "now " << total.throughput << " " << total.unit
+                  << " | baseline " << it->second.throughput << " " << it->second.unit << " | "
+                  << std::showpos << std::fixed << std::setprecision(1) << delta * 100.0 << "%" << std::noshowpos
+                  << (ok ? "  PASS" : "  FAIL");
+        if (total.threads != it->second.threads) std::cout << " (" << total.threads << " vs " << it->second.threads << " threads)";
+        std::cout << "\n";
+        std::cout.flags(flags);
+    }
+    std::cout << "Baseline gate: " << (passed ? "PASS" : "FAIL") << "\n";
+    std::cout << "======================================\n";
+    return passed;
+}
@@ -0,0 +1,40 @@
+#include "sensors.hpp"
+#include <filesystem>
+#include <fstream>
+
+std::string Sensors::findSensor(const std::string& pattern) {
+    try {
+        for (const auto& entry : std::filesystem::directory_iterator("/sys/class/hwmon")) {
+            std::ifstream file(entry.path() / "name");
+            std::string name;
+            if (file >> name && name.find(pattern) != std::string::npos) {
+                const auto input = entry.path() / "temp1_input";
+                if (std::filesystem::exists(input)) return input.string();
+            }
+        }
+    } catch (...) {}
+    return {};
+}
+
+std::optional<float> Sensors::readTemp(const std::string& path) {
+    if (path.empty()) return std::nullopt;
+    std::ifstream file(path);
+    int temp;
+    if (!(file >> temp)) return std::nullopt;
+    return temp / 1000.0f;
+}
+
+std::optional<float> Sensors::cpuTemp() {
+    static const std::string path = [] {
+        for (const char* pattern : {"coretemp", "k10temp", "zenpower"}) {
+            if (auto found = findSensor(pattern); !found.empty()) return found;
+        }
+        return std::string();
+    }();
+    return readTemp(path);
+}
+
+std::optional<float> Sensors::gpuTemp() {
+    static const std::string path = findSensor("amdgpu");
+    return readTemp(path);
+}
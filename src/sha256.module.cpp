@@ -0,0 +1,262 @@
+#include "sha256.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+alignas(64) constexpr uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+constexpr uint32_t H0[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+uint32_t loadBigEndian(const uint8_t* bytes) {
+    uint32_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return __builtin_bswap32(word);
+}
+
+// A compression function takes the state of every lane, word-major (state[word * lanes + lane]),
+// and one pointer per lane to blocks consecutive blocks.
+using Compress = void (*)(uint32_t* state, const uint8_t* const* data, size_t blocks);
+
+constexpr uint32_t rotr(const uint32_t x, const int n) { return x >> n | x << (32 - n); }
+
+void compressScalar(uint32_t* state, const uint8_t* const* data, const size_t blocks) {
+    for (size_t block = 0; block < blocks; ++block) {
+        const uint8_t* bytes = data[0] + block * Sha256::BLOCK;
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) w[i] = loadBigEndian(bytes + 4 * i);
+        for (int i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ w[i - 15] >> 3;
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ w[i - 2] >> 10;
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+// The SHA extensions keep the state as ABEF and CDGH; sha256rnds2 does two rounds and
+// sha256msg1/msg2 four words of the schedule.
+__attribute__((target("sha,sse4.1"))) void compressShaNi(uint32_t* state, const uint8_t* const* data, const size_t blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    const __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+    const __m128i hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    __m128i cdgh = _mm_blend_epi16(hgfe, dcba, 0xf0);
+
+    for (size_t block = 0; block < blocks; ++block) {
+        const uint8_t* bytes = data[0] + block * Sha256::BLOCK;
+        const __m128i abef_in = abef, cdgh_in = cdgh;
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i)
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 16 * i)), byte_swap);
+#pragma GCC unroll 16
+        for (int g = 0; g < 16; ++g) {
+            const __m128i wk = _mm_add_epi32(msg[g & 3], _mm_load_si128(reinterpret_cast<const __m128i*>(K + 4 * g)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+            // Words 4(g+4) .. 4(g+4)+3 replace words 4g .. 4g+3, which the rounds above were the last to use
+            if (g < 12) {
+                const __m128i w7 = _mm_alignr_epi8(msg[(g + 3) & 3], msg[(g + 2) & 3], 4);
+                msg[g & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(msg[g & 3], msg[(g + 1) & 3]), w7), msg[(g + 3) & 3]);
+            }
+        }
+        abef = _mm_add_epi32(abef, abef_in);
+        cdgh = _mm_add_epi32(cdgh, cdgh_in);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+// Multi-buffer rounds on GCC vector types, one stream per lane. Always inlined into the
+// target-specific wrappers below, so the same source compiles to AVX2 or AVX-512 (where the
+// rotates become vprord and the Ch/Maj/Sigma chains vpternlogd).
+// A macro, since a function taking vectors by value would need the ABI of a target it lacks
+#define ROTR_LANES(x, n) ((x) >> (n) | (x) << (32 - (n)))
+
+template <typename V, size_t Lanes>
+[[gnu::always_inline]] inline void compressLanes(uint32_t* state, const uint8_t* const* data, const size_t blocks) {
+    V s[8];
+    std::memcpy(s, state, sizeof(s));
+    for (size_t block = 0; block < blocks; ++block) {
+        // Transposed message: word i of every lane in one vector
+        alignas(sizeof(V)) uint32_t words[16][Lanes];
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            const uint8_t* bytes = data[lane] + block * Sha256::BLOCK;
+            for (int i = 0; i < 16; ++i) words[i][lane] = loadBigEndian(bytes + 4 * i);
+        }
+        V w[16];
+        std::memcpy(w, words, sizeof(w));
+
+        V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+        for (int i = 0; i < 64; ++i) {
+            // The schedule rolls through 16 entries: w[i & 15] is word i once rounds reach it
+            if (i >= 16) {
+                const V w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+                const V s0 = ROTR_LANES(w15, 7) ^ ROTR_LANES(w15, 18) ^ (w15 >> 3);
+                const V s1 = ROTR_LANES(w2, 17) ^ ROTR_LANES(w2, 19) ^ (w2 >> 10);
+                w[i & 15] += s0 + w[(i - 7) & 15] + s1;
+            }
+            const V t1 = h + (ROTR_LANES(e, 6) ^ ROTR_LANES(e, 11) ^ ROTR_LANES(e, 25))
+                       + ((e & f) ^ (~e & g)) + K[i] + w[i & 15];
+            const V t2 = (ROTR_LANES(a, 2) ^ ROTR_LANES(a, 13) ^ ROTR_LANES(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+        s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+    }
+    std::memcpy(state, s, sizeof(s));
+}
+
+using Lanes8 = uint32_t __attribute__((vector_size(32)));
+using Lanes16 = uint32_t __attribute__((vector_size(64)));
+
+__attribute__((target("avx2"))) void compressAvx2(uint32_t* state, const uint8_t* const* data, const size_t blocks) {
+    compressLanes<Lanes8, 8>(state, data, blocks);
+}
+
+__attribute__((target("avx512f"))) void compressAvx512(uint32_t* state, const uint8_t* const* data, const size_t blocks) {
+    compressLanes<Lanes16, 16>(state, data, blocks);
+}
+#undef ROTR_LANES
+
+// Streams of equal length share their padding layout: the full blocks straight from the
+// caller's buffers, then the rest, 0x80, zeros and the bit length in one or two more blocks.
+template <size_t Lanes>
+void hashGroups(const Compress compress, const uint8_t* const* data, const size_t size, Sha256::Digest* digests, const size_t count) {
+    const size_t full = size / Sha256::BLOCK;
+    const size_t rest = size % Sha256::BLOCK;
+    const size_t tail_blocks = rest < Sha256::BLOCK - 8 ? 1 : 2;
+    for (size_t first = 0; first < count; first += Lanes) {
+        const size_t used = std::min(Lanes, count - first);
+        const uint8_t* streams[Lanes];
+        for (size_t lane = 0; lane < Lanes; ++lane) streams[lane] = data[first + std::min(lane, used - 1)]; // spare lanes repeat the last stream
+
+        uint32_t state[8 * Lanes];
+        for (size_t word = 0; word < 8; ++word) std::fill_n(state + word * Lanes, Lanes, H0[word]);
+        compress(state, streams, full);
+
+        alignas(64) uint8_t tail[Lanes][2 * Sha256::BLOCK] = {};
+        const uint8_t* tails[Lanes];
+        const uint64_t bits = static_cast<uint64_t>(size) * 8;
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            if (rest) std::memcpy(tail[lane], streams[lane] + full * Sha256::BLOCK, rest);
+            tail[lane][rest] = 0x80;
+            for (int i = 0; i < 8; ++i) tail[lane][tail_blocks * Sha256::BLOCK - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+            tails[lane] = tail[lane];
+        }
+        compress(state, tails, tail_blocks);
+
+        for (size_t lane = 0; lane < used; ++lane)
+            for (size_t word = 0; word < 8; ++word) {
+                const uint32_t value = state[word * Lanes + lane];
+                for (int i = 0; i < 4; ++i) digests[first + lane][4 * word + i] = static_cast<uint8_t>(value >> (24 - 8 * i));
+            }
+    }
+}
+
+Sha256::Digest parseDigest(const char* hex) {
+    Sha256::Digest digest{};
+    for (size_t i = 0; i < digest.size(); ++i) {
+        const auto nibble = [](const char c) { return static_cast<uint8_t>(c <= '9' ? c - '0' : c - 'a' + 10); };
+        digest[i] = static_cast<uint8_t>(nibble(hex[2 * i]) << 4 | nibble(hex[2 * i + 1]));
+    }
+    return digest;
+}
+
+} // namespace
+
+Sha256::Digest Sha256::hash(const void* data, const size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    Digest digest;
+    hash(CpuDispatch::get().supports(Engine::ShaNi) ? Engine::ShaNi : Engine::Software, &bytes, size, &digest, 1);
+    return digest;
+}
+
+void Sha256::hash(const Engine engine, const uint8_t* const* data, const size_t size, Digest* digests, const size_t count) {
+    if (count == 0) return;
+    switch (engine) {
+    case Engine::ShaNi: return hashGroups<1>(compressShaNi, data, size, digests, count);
+    case Engine::Avx512: return hashGroups<16>(compressAvx512, data, size, digests, count);
+    case Engine::Avx2: return hashGroups<8>(compressAvx2, data, size, digests, count);
+    case Engine::Software: break;
+    }
+    hashGroups<1>(compressScalar, data, size, digests, count);
+}
+
+size_t Sha256::lanes(const Engine engine) {
+    switch (engine) {
+    case Engine::Avx512: return 16;
+    case Engine::Avx2: return 8;
+    default: return 1;
+    }
+}
+
+bool Sha256::selfTest(const Engine engine, std::string& failure) {
+    // FIPS 180-2 appendix B examples, the empty message and the 896-bit message of FIPS 180-4's examples
+    struct Vector {
+        std::string message;
+        const char* digest;
+    };
+    const Vector vectors[] = {
+        {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+        {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+        {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+        {"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+         "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1"},
+        {std::string(1000000, 'a'), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+    };
+    const size_t lanes = Sha256::lanes(engine);
+    for (const auto& vector : vectors) {
+        std::vector<const uint8_t*> streams(lanes, reinterpret_cast<const uint8_t*>(vector.message.data()));
+        std::vector<Digest> digests(lanes);
+        hash(engine, streams.data(), vector.message.size(), digests.data(), lanes);
+        for (const auto& digest : digests) {
+            if (digest != parseDigest(vector.digest)) {
+                failure = std::string(CpuDispatch::name(engine)) + ": wrong digest of the " + std::to_string(vector.message.size())
+                        + "-byte FIPS vector";
+                return false;
+            }
+        }
+    }
+
+    // Distinct streams in every lane, across each padding case and a partial last group
+    std::vector<uint8_t> bytes(3 * BLOCK * (lanes + 1));
+    for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(i * 167 + (i >> 8) * 13);
+    for (size_t size = 0; size <= 2 * BLOCK + 1; ++size) {
+        const size_t count = lanes + lanes / 2 + 1;
+        std::vector<const uint8_t*> streams(count);
+        for (size_t i = 0; i < count; ++i) streams[i] = bytes.data() + (i * 37) % (bytes.size() - size);
+        std::vector<Digest> digests(count), reference(count);
+        hash(engine, streams.data(), size, digests.data(), count);
+        hash(Engine::Software, streams.data(), size, reference.data(), count);
+        if (digests != reference) {
+            failure = std::string(CpuDispatch::name(engine)) + ": differs from the portable engine on " + std::to_string(size) + "-byte streams";
+            return false;
+        }
+    }
+    return true;
+}
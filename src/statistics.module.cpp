@@ -0,0 +1,74 @@
+#include "statistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+Statistics::Summary Statistics::summarize(const std::span<const double> values) {
+    Summary s;
+    s.count = values.size();
+    if (values.empty()) return s;
+
+    std::vector<double> sorted(values.begin(), values.end());
+    std::ranges::sort(sorted);
+    s.total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+    s.mean = s.total / s.count;
+    if (s.count > 1) {
+        double squares = 0;
+        for (const double v : sorted) squares += (v - s.mean) * (v - s.mean);
+        s.stddev = std::sqrt(squares / (s.count - 1));
+    }
+    s.cv = s.mean != 0 ? s.stddev / s.mean : 0;
+    s.min = sorted.front();
+    s.max = sorted.back();
+    s.p5 = percentile(sorted, 0.05);
+    s.p50 = percentile(sorted, 0.50);
+    s.p95 = percentile(sorted, 0.95);
+    return s;
+}
+
+double Statistics::percentile(const std::span<const double> sorted, const double p) {
+    if (sorted.empty()) return 0;
+    const double rank = std::clamp(p, 0.0, 1.0) * (sorted.size() - 1);
+    const size_t below = static_cast<size_t>(rank);
+    const size_t above = std::min(below + 1, sorted.size() - 1);
+    return sorted[below] + (sorted[above] - sorted[below]) * (rank - below);
+}
+
+std::vector<Statistics::Outlier> Statistics::outliers(const std::span<const double> values, const double min_deviation, const double z_limit) {
+    std::vector<Outlier> found;
+    if (values.size() < 3) return found;
+
+    std::vector<double> sorted(values.begin(), values.end());
+    std::ranges::sort(sorted);
+    const double median = percentile(sorted, 0.5);
+    if (median == 0) return found;
+
+    std::vector<double> spread;
+    spread.reserve(values.size());
+    for (const double v : values) spread.push_back(std::abs(v - median));
+    std::ranges::sort(spread);
+    const double mad = percentile(spread, 0.5);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        const double deviation = (values[i] - median) / median;
+        const double z = mad > 0 ? 0.6745 * (values[i] - median) / mad : 0;
+        if (std::abs(deviation) < min_deviation) continue;
+        if (mad > 0 && std::abs(z) < z_limit) continue;
+        found.push_back({i, values[i], deviation, z});
+    }
+    return found;
+}
+
+std::optional<Statistics::Interval> Statistics::confidence95(const std::span<const double> runs) {
+    // Two-sided 97.5% quantiles of Student's t for 1..30 degrees of freedom
+    static constexpr double T975[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (runs.size() < 2) return std::nullopt;
+
+    const Summary s = summarize(runs);
+    const size_t df = runs.size() - 1;
+    const double t = df <= std::size(T975) ? T975[df - 1] : 1.960;
+    return Interval{runs.size(), s.mean, t * s.stddev / std::sqrt(static_cast<double>(runs.size()))};
+}
@@ -4,10 +4,12 @@
 #include <chrono>
 #include <vector>
 #include <string>
-#include <filesystem>
 #include <memory>
 #include <array>
 
+#include "sensors.hpp"
+#include "cpuFrequency.hpp"
+
 #include "imgui/imgui.h"
 #include "imgui/backends/imgui_impl_glfw.h"
 #include "imgui/backends/imgui_impl_opengl3.h"
@@ -44,8 +46,6 @@ class Monitor {
     bool running_{false};
     Metrics metrics_;
     History history_;
-    std::string cpu_sensor_;
-    std::string gpu_sensor_;
 
     void setup_theme() {
         auto& style = ImGui::GetStyle();
@@ -67,31 +67,6 @@ class Monitor {
         style.ItemSpacing = {12, 8};
     }
 
-    std::string find_sensor(const std::string& pattern) {
-        try {
-            for (const auto& entry : std::filesystem::directory_iterator("/sys/class/hwmon")) {
-                auto name_path = entry.path() / "name";
-                std::ifstream file(name_path);
-                std::string name;
-                if (file >> name && name.find(pattern) != std::string::npos) {
-                    for (const auto& temp_file : std::filesystem::directory_iterator(entry.path())) {
-                        if (temp_file.path().filename().string().contains("temp1_input")) {
-                            return temp_file.path();
-                        }
-                    }
-                }
-            }
-        } catch (...) {}
-        return {};
-    }
-
-    float read_temp(const std::string& path) {
-        if (path.empty()) return 0;
-        std::ifstream file(path);
-        int temp;
-        return file >> temp ? temp / 1000.0f : 0;
-    }
-
     float read_cpu_usage() {
         static long last_idle{0}, last_total{0};
         std::ifstream file("/proc/stat");
@@ -129,9 +104,10 @@ class Monitor {
     }
 
     void update_metrics() {
-        metrics_.cpu_temp = read_temp(cpu_sensor_);
-        metrics_.gpu_temp = read_temp(gpu_sensor_);
+        metrics_.cpu_temp = Sensors::cpuTemp().value_or(0);
+        metrics_.gpu_temp = Sensors::gpuTemp().value_or(0);
         metrics_.cpu_usage = read_cpu_usage();
+        metrics_.cpu_freq = static_cast<int>(FrequencySampler::currentMHz());
         metrics_.memory_usage = read_memory_usage();
 
         history_.push(metrics_.cpu_temp, metrics_.gpu_temp, metrics_.cpu_usage);
@@ -151,6 +127,7 @@ class Monitor {
             ImGui::TextDisabled("CPU");
             ImGui::Text("%.0f°C", metrics_.cpu_temp);
             ImGui::Text("%.0f%%", metrics_.cpu_usage);
+            ImGui::Text("%d MHz", metrics_.cpu_freq);
 
             ImGui::TableNextColumn();
             ImGui::TextDisabled("GPU");
@@ -212,9 +189,6 @@ public:
         ImGui_ImplGlfw_InitForOpenGL(window_, true);
         ImGui_ImplOpenGL3_Init("#version 330");
 
-        cpu_sensor_ = find_sensor("coretemp");
-        gpu_sensor_ = find_sensor("amdgpu");
-
         return true;
     }
 
@@ -0,0 +1,208 @@
+#include "topology.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int read_int(const std::filesystem::path& path, const int fallback) {
+    std::ifstream file(path);
+    int value;
+    return file >> value ? value : fallback;
+}
+
+// Parses the kernel's cpulist format, e.g. "0-3,8-11".
+std::vector<int> read_cpu_list(const std::filesystem::path& path) {
+    std::vector<int> cpus;
+    std::ifstream file(path);
+    std::string list;
+    if (!(file >> list)) return cpus;
+
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        const auto dash = range.find('-');
+        try {
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (...) {}
+    }
+    return cpus;
+}
+
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+int l3_domain(const std::filesystem::path& cpu_dir, const int cpu) {
+    try {
+        for (const auto& index : std::filesystem::directory_iterator(cpu_dir / "cache")) {
+            if (!index.path().filename().string().starts_with("index")) continue;
+            if (read_int(index.path() / "level", 0) != 3) continue;
+            const auto shared = read_cpu_list(index.path() / "shared_cpu_list");
+            if (!shared.empty()) return *std::ranges::min_element(shared);
+        }
+    } catch (...) {}
+    return cpu;
+}
+
+auto core_order(const Topology::Cpu& c) { return std::tie(c.package, c.core, c.smt, c.id); }
+
+} // namespace
+
+Topology Topology::detect() {
+    const std::filesystem::path sys_cpu = "/sys/devices/system/cpu";
+
+    std::map<int, int> cpu_node;
+    try {
+        for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node")) {
+            const auto name = entry.path().filename().string();
+            if (!name.starts_with("node") || name.size() == 4) continue;
+            const int node = std::atoi(name.c_str() + 4);
+            for (const int cpu : read_cpu_list(entry.path() / "cpulist")) cpu_node[cpu] = node;
+        }
+    } catch (...) {}
+
+    Topology topology;
+    for (const int id : allowed_cpus()) {
+        const auto dir = sys_cpu / ("cpu" + std::to_string(id));
+        const auto siblings = read_cpu_list(dir / "topology" / "thread_siblings_list");
+        const auto self = std::ranges::find(siblings, id);
+
+        Cpu cpu{};
+        cpu.id = id;
+        cpu.package = read_int(dir / "topology" / "physical_package_id", 0);
+        cpu.core = read_int(dir / "topology" / "core_id", id);
+        cpu.smt = self == siblings.end() ? 0 : static_cast<int>(self - siblings.begin());
+        cpu.l3 = l3_domain(dir, id);
+        cpu.node = cpu_node.contains(id) ? cpu_node[id] : 0;
+        topology.cpus_.push_back(cpu);
+    }
+    return topology;
+}
+
+std::vector<int> Topology::place(const Placement policy, int node) const {
+    std::vector<Cpu> order = cpus_;
+    std::ranges::sort(order, [](const Cpu& a, const Cpu& b) { return core_order(a) < core_order(b); });
+
+    std::vector<int> result;
+    switch (policy) {
+    case Placement::FillSmt:
+        for (const auto& cpu : order) result.push_back(cpu.id);
+        break;
+
+    case Placement::PhysicalCores: {
+        std::set<std::pair<int, int>> seen;
+        for (const auto& cpu : order) {
+            if (seen.insert({cpu.package, cpu.core}).second) result.push_back(cpu.id);
+        }
+        break;
+    }
+
+    case Placement::SpreadL3: {
+        // Each domain lists first threads of all its cores before any sibling
+        std::map<int, std::vector<Cpu>> domains;
+        for (const auto& cpu : order) domains[cpu.l3].push_back(cpu);
+        for (auto& [l3, members] : domains) {
+            std::ranges::stable_sort(members, [](const Cpu& a, const Cpu& b) { return a.smt < b.smt; });
+        }
+        for (size_t i = 0; result.size() < order.size(); ++i) {
+            for (const auto& [l3, members] : domains) {
+                if (i < members.size()) result.push_back(members[i].id);
+            }
+        }
+        break;
+    }
+
+    case Placement::PackNode:
+        if (node < 0 && !order.empty()) node = cpus_.front().node;
+        for (const auto& cpu : order) {
+            if (cpu.node == node) result.push_back(cpu.id);
+        }
+        break;
+    }
+
+    if (result.empty()) {
+        for (const auto& cpu : order) result.push_back(cpu.id);
+    }
+    return result;
+}
+
+int Topology::nodeOf(const int cpu) const {
+    const auto it = std::ranges::find(cpus_, cpu, &Cpu::id);
+    return it == cpus_.end() ? 0 : it->node;
+}
+
+std::vector<int> Topology::nodes() const {
+    std::set<int> nodes;
+    for (const auto& cpu : cpus_) nodes.insert(cpu.node);
+    return {nodes.begin(), nodes.end()};
+}
+
+std::string Topology::summary() const {
+    std::set<int> packages, l3s;
+    std::set<std::pair<int, int>> cores;
+    for (const auto& cpu : cpus_) {
+        packages.insert(cpu.package);
+        cores.insert({cpu.package, cpu.core});
+        l3s.insert(cpu.l3);
+    }
+    std::ostringstream out;
+    out << packages.size() << " package(s), " << cores.size() << " core(s), " << cpus_.size()
+        << " allowed CPU(s), " << l3s.size() << " L3 domain(s), " << nodes().size() << " NUMA node(s)";
+    return out.str();
+}
+
+// Raw syscalls rather than libnuma, so there is no extra runtime dependency.
+bool Topology::bindMemory(void* addr, const size_t size, const int node) {
+    constexpr int MAX_NODES = 1024;
+    if (node < 0 || node >= MAX_NODES) return false;
+    unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))] = {};
+    mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+    return syscall(SYS_mbind, addr, size, MPOL_BIND, mask, MAX_NODES + 1, MPOL_MF_MOVE) == 0;
+}
+
+int Topology::memoryNode(const void* addr) {
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, addr, MPOL_F_NODE | MPOL_F_ADDR) != 0) return -1;
+    return node;
+}
+
+std::optional<Topology::Placement> Topology::parsePlacement(const std::string_view name) {
+    if (name == "core") return Placement::PhysicalCores;
+    if (name == "smt") return Placement::FillSmt;
+    if (name == "l3") return Placement::SpreadL3;
+    if (name == "node") return Placement::PackNode;
+    return std::nullopt;
+}
+
+const char* Topology::name(const Placement policy) {
+    switch (policy) {
+    case Placement::PhysicalCores: return "core";
+    case Placement::FillSmt: return "smt";
+    case Placement::SpreadL3: return "l3";
+    case Placement::PackNode: return "node";
+    }
+    return "?";
+}
@@ -0,0 +1,127 @@
+#include "workerPool.hpp"
+#include "topology.hpp"
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+
+void WorkerPool::Group::wait() {
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this] { return pending == 0; });
+}
+
+void WorkerPool::Group::finish() {
+    std::lock_guard lock(mutex);
+    if (--pending == 0) done.notify_all();
+}
+
+WorkerPool::WorkerPool(std::vector<int> cpus) {
+    spawn(std::move(cpus));
+}
+
+WorkerPool::~WorkerPool() {
+    shutdown();
+}
+
+void WorkerPool::reset(std::vector<int> cpus) {
+    shutdown();
+    spawn(std::move(cpus));
+}
+
+void WorkerPool::spawn(std::vector<int> cpus) {
+    if (cpus.empty()) cpus.push_back(0);
+    stopping_ = false;
+    workers_.reserve(cpus.size());
+    for (const int cpu : cpus) {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_.back()->cpu = cpu;
+    }
+    for (unsigned i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&WorkerPool::loop, this, i);
+    }
+}
+
+void WorkerPool::shutdown() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (const auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    workers_.clear();
+}
+
+void WorkerPool::submit(Group& group, const unsigned worker, Task task) {
+    {
+        std::lock_guard lock(group.mutex);
+        ++group.pending;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        workers_[worker % size()]->tasks.emplace_back([&group, task = std::move(task)] {
+            task();
+            group.finish();
+        });
+    }
+    wake_.notify_all();
+}
+
+void WorkerPool::parallel(const unsigned count, const std::function<void(unsigned)>& fn, const unsigned first_worker) {
+    Group group;
+    for (unsigned i = 0; i < count; ++i) {
+        submit(group, first_worker + i, [&fn, i] { fn(i); });
+    }
+    group.wait();
+}
+
+// A worker only steals from a busy peer: tasks waiting on an idle worker are left for it,
+// so a task lands on the core it was submitted to unless that core is already occupied.
+int WorkerPool::findVictim(const unsigned self) const {
+    for (unsigned offset = 1; offset < workers_.size(); ++offset) {
+        const unsigned victim = (self + offset) % size();
+        if (workers_[victim]->busy && !workers_[victim]->tasks.empty()) return static_cast<int>(victim);
+    }
+    return -1;
+}
+
+void WorkerPool::loop(const unsigned self) {
+    Worker& me = *workers_[self];
+    pinThread(me.cpu);
+
+    std::unique_lock lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [&] { return stopping_ || !me.tasks.empty() || findVictim(self) >= 0; });
+        if (stopping_) return;
+
+        Task task;
+        if (!me.tasks.empty()) {
+            task = std::move(me.tasks.back());
+            me.tasks.pop_back();
+        } else {
+            auto& victim = *workers_[findVictim(self)];
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+
+        me.busy = true;
+        // Whatever is still queued here is now up for stealing.
+        if (!me.tasks.empty()) wake_.notify_all();
+        lock.unlock();
+        task();
+        lock.lock();
+        me.busy = false;
+    }
+}
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool pool(Topology::detect().place(Topology::Placement::FillSmt));
+    return pool;
+}
+
+void WorkerPool::pinThread(const int cpu) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+}